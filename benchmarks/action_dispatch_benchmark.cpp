@@ -0,0 +1,105 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "item_blueprint.hpp"
+#include "symbol.hpp"
+
+// Compares looking up the actions of a verb in the per-category table of `ItemBlueprint` with the linear
+// scan over all (category, actions) pairs that was used before, for blueprints with more and more
+// categories. Half of the lookups are for verbs that the blueprint has no actions for, like most commands.
+
+using Clock = std::chrono::steady_clock;
+
+// The layout before the table: every action list next to the name of its category, in definition order.
+using ScannedActions = std::vector<std::pair<c2k::Utf8String, ActionList>>;
+
+static constexpr auto alternatives_per_category = usize{ 2 };
+static constexpr auto lookups = usize{ 1'000'000 };
+
+[[nodiscard]] static c2k::Utf8String category_name(usize const index) {
+    return c2k::Utf8String{ "verb_" + std::to_string(index) };
+}
+
+[[nodiscard]] static usize count_scanned(ScannedActions const& actions, c2k::Utf8StringView const category) {
+    auto count = usize{ 0 };
+    for (auto const& [action_category, action_list] : actions) {
+        if (action_category != category) {
+            continue;
+        }
+        ++count;
+    }
+    return count;
+}
+
+// Like the world, the category of the command is resolved to a symbol once per lookup.
+[[nodiscard]] static usize count_indexed(ItemBlueprint const& blueprint, c2k::Utf8StringView const category) {
+    if (auto const symbol = Symbol::find(category)) {
+        return blueprint.actions(symbol.value()).size();
+    }
+    return 0;
+}
+
+template<typename Query, typename Lookup>
+[[nodiscard]] static double nanoseconds_per_lookup(std::vector<Query> const& queries, Lookup const& lookup) {
+    auto found = usize{ 0 };
+    auto const start = Clock::now();
+    for (auto i = usize{ 0 }; i < lookups; ++i) {
+        found += lookup(queries.at(i % queries.size()));
+    }
+    auto const duration = std::chrono::duration<double, std::nano>{ Clock::now() - start };
+    // Every query for a defined category finds all of its alternatives.
+    if (found != lookups / 2 * alternatives_per_category) {
+        throw std::runtime_error{ "Lookups found " + std::to_string(found) + " action lists." };
+    }
+    return duration.count() / static_cast<double>(lookups);
+}
+
+static void run(usize const category_count) {
+    auto scanned = ScannedActions{};
+    auto indexed = ItemBlueprint::Actions{};
+    for (auto alternative = usize{ 0 }; alternative < alternatives_per_category; ++alternative) {
+        for (auto i = usize{ 0 }; i < category_count; ++i) {
+            scanned.emplace_back(category_name(i), ActionList{});
+            indexed[Symbol{ category_name(i) }].emplace_back();
+        }
+    }
+    auto const blueprint = ItemBlueprint{
+        Symbol{ c2k::Utf8String{ "benchmark_item" } },
+        c2k::Utf8String{ "Item" },
+        StyledText{ "" },
+        {},
+        std::move(indexed),
+    };
+
+    // Defined and undefined categories alternate. The undefined ones are interned as well, since the
+    // verbs of other items are known symbols.
+    auto queries = std::vector<c2k::Utf8String>{};
+    auto symbols = std::vector<Symbol>{};
+    for (auto i = usize{ 0 }; i < category_count; ++i) {
+        queries.push_back(category_name(i));
+        queries.push_back(category_name(category_count + i));
+        symbols.emplace_back(queries.at(queries.size() - 2));
+        symbols.emplace_back(queries.back());
+    }
+
+    auto const scan = nanoseconds_per_lookup(queries, [&](auto const& query) { return count_scanned(scanned, query); });
+    auto const table =
+        nanoseconds_per_lookup(queries, [&](auto const& query) { return count_indexed(blueprint, query); });
+    // The world resolves the symbol once per command, no matter how many items it tries.
+    auto const resolved =
+        nanoseconds_per_lookup(symbols, [&](Symbol const symbol) { return blueprint.actions(symbol).size(); });
+    std::cout << std::setw(10) << category_count << std::setw(12) << scan << std::setw(12) << table << std::setw(12)
+              << resolved << std::setw(12) << scan / table << '\n';
+}
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "categories        scan       table    resolved     speedup   (ns per lookup)\n";
+    for (auto const category_count : { usize{ 1 }, usize{ 4 }, usize{ 16 }, usize{ 64 }, usize{ 256 } }) {
+        run(category_count);
+    }
+}
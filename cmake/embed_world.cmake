@@ -0,0 +1,13 @@
+# Turns the world image INPUT into the C++ source file OUTPUT, which defines `embedded_world_image()`.
+file(READ ${INPUT} image_contents HEX)
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," image_bytes "${image_contents}")
+file(WRITE ${OUTPUT}
+        "#include \"embedded_world.hpp\"\n"
+        "\n"
+        "// The reader requires the sections of the image to be aligned.\n"
+        "alignas(8) static constexpr unsigned char image[] = { ${image_bytes} };\n"
+        "\n"
+        "[[nodiscard]] std::span<std::byte const> embedded_world_image() {\n"
+        "    return std::as_bytes(std::span{ image });\n"
+        "}\n"
+)
@@ -28,6 +28,9 @@ else ()
     option(guess_what_enable_address_sanitizer "Enable address sanitizer" OFF)
     option(guess_what_build_tests "Build unit tests" OFF)
 endif ()
+option(guess_what_build_benchmarks "Build the benchmarks" OFF)
+option(guess_what_embed_world "Compile the content at build time and embed it into the executable" OFF)
+option(guess_what_builtin_words "Generate the lookup tables for the synonym lists and the ignore list at build time" OFF)
 option(guess_what_build_shared_libs "Build shared libraries instead of static libraries" ON)
 set(BUILD_SHARED_LIBS ${guess_what_build_shared_libs})
 
@@ -0,0 +1,112 @@
+#include "action.hpp"
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include "item.hpp"
+
+[[nodiscard]] static u32 narrow(usize const value) {
+    if (value > std::numeric_limits<u32>::max()) {
+        throw std::runtime_error{ "Too many action operands." };
+    }
+    return static_cast<u32>(value);
+}
+
+void ActionList::emit(Opcode const opcode) {
+    m_instructions.push_back(Instruction{ opcode, 0, 0 });
+}
+
+void ActionList::emit(Opcode const opcode, c2k::Utf8StringView const text) {
+    m_instructions.push_back(Instruction{ opcode, narrow(m_texts.size()), 1 });
+    m_texts.emplace_back(text);
+}
+
+void ActionList::emit(Opcode const opcode, std::vector<Symbol> const& symbols) {
+    m_instructions.push_back(Instruction{ opcode, narrow(m_symbols.size()), narrow(symbols.size()) });
+    m_symbols.insert(m_symbols.end(), symbols.cbegin(), symbols.cend());
+}
+
+void ActionList::emit(Opcode const opcode, FlagSet flags) {
+    m_instructions.push_back(Instruction{ opcode, narrow(m_flag_sets.size()), 1 });
+    m_flag_sets.push_back(std::move(flags));
+}
+
+void ActionList::for_each_symbol(std::function<void(Opcode, Symbol)> const& function) const {
+    for (auto const& [opcode, first, count] : m_instructions) {
+        if (opcode == Opcode::Print or opcode == Opcode::Define or opcode == Opcode::Undefine or opcode == Opcode::If
+            or opcode == Opcode::IfNot) {
+            continue;
+        }
+        for (auto const symbol : std::span{ m_symbols }.subspan(first, count)) {
+            function(opcode, symbol);
+        }
+    }
+}
+
+[[nodiscard]] bool ActionList::execute(
+    Item& item,
+    std::vector<Item*> const& targets,
+    ActionContext const& context
+) const {
+    for (auto const& [opcode, first, count] : m_instructions) {
+        auto const symbols = [&] { return std::span{ m_symbols }.subspan(first, count); };
+        switch (opcode) {
+            case Opcode::Print:
+                context.terminal().println(m_texts[first]);
+                break;
+            case Opcode::With:
+                for (auto const symbol : symbols()) {
+                    if (std::none_of(targets.cbegin(), targets.cend(), [&](auto const target) {
+                            return target->blueprint().reference() == symbol;
+                        })) {
+                        return false;
+                    }
+                }
+                break;
+            case Opcode::ConsumeSelf:
+                context.remove_item(&item);
+                break;
+            case Opcode::Consume:
+                for (auto const symbol : symbols()) {
+                    context.remove_item(context.find_item(symbol));
+                }
+                break;
+            case Opcode::Spawn:
+                for (auto const symbol : symbols()) {
+                    context.spawn_item(symbol, SpawnLocation::Room);
+                }
+                break;
+            case Opcode::Take:
+                for (auto const symbol : symbols()) {
+                    context.spawn_item(symbol, SpawnLocation::Inventory);
+                }
+                break;
+            case Opcode::Define:
+                context.flags().insert(m_flag_sets[first]);
+                break;
+            case Opcode::Undefine:
+                context.flags().erase(m_flag_sets[first]);
+                break;
+            case Opcode::If:
+                if (not context.flags().contains_all(m_flag_sets[first])) {
+                    return false;
+                }
+                break;
+            case Opcode::IfNot:
+                if (not context.flags().contains_none(m_flag_sets[first])) {
+                    return false;
+                }
+                break;
+            case Opcode::Goto:
+                context.goto_room(symbols().front());
+                break;
+            case Opcode::Dialog:
+                context.start_dialog(symbols().front());
+                break;
+            case Opcode::Win:
+                context.win();
+                break;
+        }
+    }
+    return true;
+}
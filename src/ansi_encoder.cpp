@@ -0,0 +1,126 @@
+#include "ansi_encoder.hpp"
+#include <algorithm>
+#include <charconv>
+#include <lib2k/types.hpp>
+#include <string>
+#include <vector>
+
+// Returns the length of the escape sequence at the beginning of the bytes.
+[[nodiscard]] static usize sequence_length(std::string_view const bytes) {
+    if (bytes.size() < 2 or bytes.at(1) != '[') {
+        return 1;
+    }
+    // Control sequences end with the first byte in the range 0x40-0x7E after "ESC [".
+    for (auto i = usize{ 2 }; i < bytes.size(); ++i) {
+        if (auto const c = static_cast<u8>(bytes.at(i)); c >= 0x40 and c <= 0x7E) {
+            return i + 1;
+        }
+    }
+    return bytes.size();
+}
+
+void AnsiEncoder::write(std::string_view bytes) {
+    while (not bytes.empty()) {
+        auto const escape = bytes.find('\x1b');
+        write_text(bytes.substr(0, escape));
+        if (escape == std::string_view::npos) {
+            return;
+        }
+        bytes.remove_prefix(escape);
+        auto const length = sequence_length(bytes);
+        if (length >= 3 and bytes.at(length - 1) == 'm') {
+            apply_sgr(bytes.substr(2, length - 3));
+        } else {
+            // Other sequences (e.g. clearing the screen) may depend on the style, so it's applied first.
+            sync();
+            m_output += bytes.substr(0, length);
+        }
+        bytes.remove_prefix(length);
+    }
+}
+
+void AnsiEncoder::sync() {
+    if (m_current != m_desired) {
+        emit_style(m_desired);
+    }
+}
+
+void AnsiEncoder::write_text(std::string_view const text) {
+    if (text.empty()) {
+        return;
+    }
+    // The foreground color doesn't change how whitespace looks, so only the background has to be applied
+    // before it. This way, a color that ends right before a space and starts again after it isn't reset.
+    auto const first_visible = text.find_first_not_of(" \n");
+    if (first_visible != 0) {
+        sync_background();
+        m_output += text.substr(0, first_visible);
+    }
+    if (first_visible != std::string_view::npos) {
+        sync();
+        m_output += text.substr(first_visible);
+    }
+}
+
+void AnsiEncoder::apply_sgr(std::string_view const parameters) {
+    auto fields = std::vector<std::string_view>{};
+    for (auto rest = parameters;;) {
+        auto const separator = rest.find(';');
+        fields.push_back(rest.substr(0, separator));
+        if (separator == std::string_view::npos) {
+            break;
+        }
+        rest.remove_prefix(separator + 1);
+    }
+
+    for (auto i = usize{ 0 }; i < fields.size(); ++i) {
+        // An empty parameter is the same as 0.
+        auto code = 0;
+        std::from_chars(fields.at(i).data(), fields.at(i).data() + fields.at(i).size(), code);
+        if (code == 0) {
+            m_desired = Style{};
+        } else if (code == 38 or code == 48) {
+            // Extended colors take their arguments from the following parameters: "5;n" or "2;r;g;b".
+            auto color = std::to_string(code);
+            auto const arguments = (i + 1 < fields.size() and fields.at(i + 1) == "2") ? usize{ 4 } : usize{ 2 };
+            for (auto const end = std::min(i + 1 + arguments, fields.size()); i + 1 < end; ++i) {
+                color += ";" + std::string{ fields.at(i + 1) };
+            }
+            (code == 38 ? m_desired.foreground : m_desired.background) = std::move(color);
+        } else if ((code >= 30 and code <= 39) or (code >= 90 and code <= 97)) {
+            m_desired.foreground = std::to_string(code);
+        } else if ((code >= 40 and code <= 49) or (code >= 100 and code <= 107)) {
+            m_desired.background = std::to_string(code);
+        } else {
+            // Other attributes aren't tracked individually and are passed through as they are. Only a reset
+            // turns them off reliably, so it has to reach the terminal as long as any of them is active.
+            sync();
+            m_output += "\x1b[" + std::to_string(code) + "m";
+            m_current.has_attributes = true;
+            m_desired.has_attributes = true;
+        }
+    }
+}
+
+void AnsiEncoder::sync_background() {
+    // Attributes such as underlines are visible on whitespace, so they're applied along with the background.
+    auto const style = Style{ m_current.foreground, m_desired.background, m_desired.has_attributes };
+    if (m_current != style) {
+        emit_style(style);
+    }
+}
+
+void AnsiEncoder::emit_style(Style const& style) {
+    // Attributes that aren't tracked can only be turned off by a reset, after which the colors are set anew.
+    auto const reset = style == Style{} or (m_current.has_attributes and not style.has_attributes);
+    auto const& from = reset ? Style{} : m_current;
+    auto codes = std::string{ reset ? "0" : "" };
+    if (style.foreground != from.foreground) {
+        codes += (codes.empty() ? "" : ";") + style.foreground;
+    }
+    if (style.background != from.background) {
+        codes += (codes.empty() ? "" : ";") + style.background;
+    }
+    m_output += "\x1b[" + codes + "m";
+    m_current = style;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+// The last stage before output is sent to a terminal. SGR sequences that set colors aren't passed through, but
+// only change the desired style. Other attributes (bold, underline, ...) are passed through and remembered, so
+// that a later reset still reaches the terminal. The style is applied right before the next text that depends on it, using
+// the shortest sequence, so that redundant and superseded style changes never reach the terminal. The
+// output is collected until it's taken, so that consecutive writes end up in a single one.
+class AnsiEncoder final {
+private:
+    struct Style final {
+        // The SGR parameters of the colors, e.g. "31" or "38;5;208".
+        std::string foreground = "39";
+        std::string background = "49";
+        // Whether attributes other than colors have been passed through since the last reset.
+        bool has_attributes = false;
+
+        [[nodiscard]] friend bool operator==(Style const& lhs, Style const& rhs) = default;
+    };
+
+    Style m_current;
+    Style m_desired;
+    std::string m_output;
+
+public:
+    // Expects complete escape sequences.
+    void write(std::string_view bytes);
+
+    // Applies the desired style, e.g. before the terminal echoes the input of the player.
+    void sync();
+
+    [[nodiscard]] std::string take() {
+        return std::exchange(m_output, std::string{});
+    }
+
+private:
+    void write_text(std::string_view text);
+    void apply_sgr(std::string_view parameters);
+    void sync_background();
+    void emit_style(Style const& style);
+};
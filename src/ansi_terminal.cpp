@@ -0,0 +1,386 @@
+#include "ansi_terminal.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#ifdef _WIN32
+#include <conio.h>
+#include <io.h>
+#include "windows.hpp"
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+inline void setup_terminal() {}
+
+struct ConsoleSize final {
+    int width;
+    int height;
+};
+
+[[nodiscard]] static std::optional<ConsoleSize> console_size() {
+    auto size = winsize{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 or size.ws_col == 0 or size.ws_row == 0) {
+        return std::nullopt;
+    }
+    return ConsoleSize{ size.ws_col, size.ws_row };
+}
+
+// Set by the SIGWINCH handler. The new size is applied the next time the terminal is used. The handler
+// also writes into a pipe, so that waiting for input can't miss a resize that happens right before.
+static auto resized = std::atomic_bool{ false };
+static int resize_pipe[2] = { -1, -1 };
+static struct sigaction previous_resize_action = {};
+
+static void on_resize(int) {
+    resized = true;
+    if (resize_pipe[1] != -1) {
+        std::ignore = ::write(resize_pipe[1], "", 1);
+    }
+}
+
+static void install_resize_handler() {
+    if (pipe(resize_pipe) != 0) {
+        throw std::runtime_error{ "Unable to create pipe." };
+    }
+    for (auto const descriptor : resize_pipe) {
+        fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+    }
+    struct sigaction action = {};
+    action.sa_handler = on_resize;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGWINCH, &action, &previous_resize_action);
+}
+
+// Does nothing if the handler isn't installed. The descriptors are reset, so that they're never used
+// again once they have been closed (and possibly reused for something else).
+static void uninstall_resize_handler() {
+    if (resize_pipe[0] == -1) {
+        return;
+    }
+    sigaction(SIGWINCH, &previous_resize_action, nullptr);
+    for (auto& descriptor : resize_pipe) {
+        close(descriptor);
+        descriptor = -1;
+    }
+}
+
+// Uninstalls the resize handler when the rest of the terminal setup fails after it has been installed.
+class ResizeHandlerGuard final {
+private:
+    bool m_dismissed = false;
+
+public:
+    ResizeHandlerGuard() {
+        install_resize_handler();
+    }
+
+    ResizeHandlerGuard(ResizeHandlerGuard const& other) = delete;
+    ResizeHandlerGuard(ResizeHandlerGuard&& other) noexcept = delete;
+    ResizeHandlerGuard& operator=(ResizeHandlerGuard const& other) = delete;
+    ResizeHandlerGuard& operator=(ResizeHandlerGuard&& other) noexcept = delete;
+
+    ~ResizeHandlerGuard() {
+        if (not m_dismissed) {
+            uninstall_resize_handler();
+        }
+    }
+
+    // Keeps the handler installed, so that it's uninstalled by the destructor of the terminal instead.
+    void dismiss() {
+        m_dismissed = true;
+    }
+};
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// The typewriter mode writes everything that is due at most this often, instead of every single character.
+static constexpr auto frame_duration = std::chrono::milliseconds{ 33 };
+
+[[nodiscard]] static bool is_terminal(std::FILE* const stream) {
+#ifdef _WIN32
+    return _isatty(_fileno(stream)) != 0;
+#else
+    return isatty(fileno(stream)) != 0;
+#endif
+}
+
+// Sends the bytes to the screen, together with everything that has been written into the encoder before.
+static void write_flushed(AnsiEncoder& encoder, std::string_view const bytes) {
+    encoder.write(bytes);
+    auto const output = encoder.take();
+    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+    std::cout.flush();
+}
+
+// Waits until the deadline has passed or a key has been pressed. Since the input is line-buffered, a key
+// press only becomes visible with Enter on most platforms. The pending input is discarded, so that it
+// isn't taken as the next command.
+[[nodiscard]] static bool wait_for_key(Clock::time_point const deadline) {
+    if (not is_terminal(stdin)) {
+        std::this_thread::sleep_until(deadline);
+        return false;
+    }
+#ifdef _WIN32
+    while (Clock::now() < deadline) {
+        if (_kbhit() != 0) {
+            while (_kbhit() != 0) {
+                std::ignore = _getch();
+            }
+            return true;
+        }
+        auto const remaining = deadline - Clock::now();
+        std::this_thread::sleep_for(std::min<Clock::duration>(std::chrono::milliseconds{ 10 }, remaining));
+    }
+    return false;
+#else
+    auto const remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+    auto descriptor = pollfd{ STDIN_FILENO, POLLIN, 0 };
+    if (poll(&descriptor, 1, static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0))) <= 0) {
+        return false;
+    }
+    tcflush(STDIN_FILENO, TCIFLUSH);
+    return true;
+#endif
+}
+
+// Waits until input is available. Returns `false` if the wait has been interrupted by a resize.
+[[nodiscard]] static bool wait_for_input() {
+#ifdef _WIN32
+    return true;
+#else
+    if (not is_terminal(stdin) or resize_pipe[0] == -1) {
+        return true;
+    }
+    auto descriptors = std::array{
+        pollfd{ STDIN_FILENO, POLLIN, 0 },
+        pollfd{ resize_pipe[0], POLLIN, 0 },
+    };
+    if (poll(descriptors.data(), descriptors.size(), -1) < 0) {
+        // Signals interrupt the wait (e.g. a resize, which is handled by the caller). Any other error would
+        // occur again on every attempt.
+        if (errno != EINTR) {
+            throw std::runtime_error{ "Unable to wait for input." };
+        }
+        return false;
+    }
+    if ((descriptors.at(1).revents & POLLIN) != 0) {
+        auto buffer = std::array<char, 64>{};
+        while (read(resize_pipe[0], buffer.data(), buffer.size()) > 0) {}
+        return false;
+    }
+    return true;
+#endif
+}
+
+// Writes the text in chunks that are split at the given offsets. Chunk `i` is written as soon as
+// `deadline(i)` has passed. A key press writes the remaining text at once.
+template<typename Deadline>
+static void write_in_chunks(
+    AnsiEncoder& encoder,
+    RenderedText const& text,
+    std::vector<usize> const& splits,
+    Deadline const& deadline
+) {
+    auto const bytes = text.bytes();
+    auto written = usize{ 0 };
+    for (auto i = usize{ 0 }; i < splits.size(); ++i) {
+        write_flushed(encoder, bytes.substr(written, splits.at(i) - written));
+        written = splits.at(i);
+        if (wait_for_key(deadline(i + 1))) {
+            break;
+        }
+    }
+    write_flushed(encoder, bytes.substr(written));
+}
+
+static void reveal(AnsiEncoder& encoder, RenderedText const& text, Pacing const& pacing) {
+    switch (pacing.mode) {
+        case Pacing::Mode::Instant:
+            write_flushed(encoder, text.bytes());
+            return;
+        case Pacing::Mode::Lines: {
+            auto const start = Clock::now();
+            write_in_chunks(encoder, text, text.line_ends(), [&](usize const line) {
+                return start + line * pacing.line_delay;
+            });
+            return;
+        }
+        case Pacing::Mode::Typewriter: {
+            // Everything that became due since the previous frame is written at once.
+            auto const start = Clock::now();
+            auto const& character_ends = text.character_ends();
+            auto const character_duration =
+                std::chrono::duration<double>{ 1.0 / std::max(pacing.characters_per_second, 1) };
+            auto frame_splits = std::vector<usize>{};
+            auto frame_starts = std::vector<Clock::time_point>{};
+            auto next_frame = start;
+            for (auto i = usize{ 0 }; i < character_ends.size(); ++i) {
+                auto const due =
+                    start + std::chrono::duration_cast<Clock::duration>(static_cast<double>(i) * character_duration);
+                if (due >= next_frame) {
+                    if (i > 0) {
+                        frame_splits.push_back(character_ends.at(i - 1));
+                    }
+                    frame_starts.push_back(due);
+                    next_frame = due + frame_duration;
+                }
+            }
+            write_in_chunks(encoder, text, frame_splits, [&](usize const frame) { return frame_starts.at(frame); });
+            return;
+        }
+    }
+}
+
+[[nodiscard]] Pacing Pacing::parse(std::string_view const text) {
+    if (text == "instant") {
+        return Pacing{ .mode = Mode::Instant };
+    }
+    if (text == "lines") {
+        return Pacing{ .mode = Mode::Lines };
+    }
+    auto characters_per_second = 0;
+    auto const end = text.data() + text.size();
+    if (auto const [pointer, error] = std::from_chars(text.data(), end, characters_per_second);
+        error != std::errc{} or pointer != end or characters_per_second <= 0) {
+        throw std::runtime_error{ "Invalid pacing \"" + std::string{ text } + "\"." };
+    }
+    return Pacing{ .mode = Mode::Typewriter, .characters_per_second = characters_per_second };
+}
+
+AnsiTerminal::AnsiTerminal(InputSource& input) : Terminal{ input } {
+    auto expected = false;
+    if (not s_initialized.compare_exchange_strong(expected, true)) {
+        throw std::runtime_error{ "Terminal may only be initialized once." };
+    }
+    // If the setup fails, the terminal doesn't count as initialized, so that it can be attempted again.
+    try {
+#ifndef _WIN32
+        auto resize_handler = std::optional<ResizeHandlerGuard>{};
+#endif
+        setup_terminal();
+        // Output that doesn't end up on a screen (e.g. when it's piped into a file) isn't slowed down, and
+        // keeps the default size.
+        m_is_screen = is_terminal(stdout);
+        if (not m_is_screen) {
+            m_pacing.mode = Pacing::Mode::Instant;
+        } else {
+            if (auto const size = console_size()) {
+                resize(size->width, size->height);
+            }
+#ifndef _WIN32
+            resize_handler.emplace();
+#endif
+        }
+        enter_alternate_screen_buffer();
+#ifndef _WIN32
+        if (resize_handler.has_value()) {
+            resize_handler->dismiss();
+        }
+#endif
+    } catch (...) {
+        s_initialized = false;
+        throw;
+    }
+}
+
+AnsiTerminal::~AnsiTerminal() noexcept {
+#ifndef _WIN32
+    if (m_is_screen) {
+        uninstall_resize_handler();
+    }
+#endif
+    show_cursor();
+    exit_alternate_screen_buffer();
+    write_flushed(m_encoder, {});
+    s_initialized = false;
+}
+
+[[nodiscard]] c2k::Utf8String AnsiTerminal::read_line() {
+    // The input is echoed in the current style. The screen is also redrawn while waiting for the player,
+    // not only on the next output.
+    m_encoder.sync();
+    write_flushed(m_encoder, {});
+    while (not wait_for_input()) {
+        apply_resize();
+    }
+    auto line = Terminal::read_line();
+    if (m_is_screen and is_terminal(stdin)) {
+        // The terminal echoes the input, so it's part of what's visible on the screen.
+        m_scrollback.add(std::string{ line.view() } + '\n');
+    }
+    return line;
+}
+
+void AnsiTerminal::write(std::string_view const bytes) {
+    if (m_is_screen) {
+        m_scrollback.add(bytes);
+    }
+    m_encoder.write(bytes);
+}
+
+void AnsiTerminal::write_paragraph(StyledText const& text) {
+    apply_resize();
+    if (m_is_screen) {
+        m_scrollback.add(text);
+    }
+    reveal(m_encoder, text.layout(width()), m_pacing);
+}
+
+void AnsiTerminal::write_clear() {
+    m_scrollback.clear();
+    m_encoder.write(ansi::clear_screen);
+}
+
+// Only the part of the output that is visible on the resized screen is wrapped again, so resizing takes
+// about the same time regardless of how long the game has been running.
+void AnsiTerminal::apply_resize() {
+    if (not m_is_screen) {
+        return;
+    }
+#ifndef _WIN32
+    // Several resizes in quick succession (e.g. while dragging the window border) are handled at once.
+    if (not resized.exchange(false)) {
+        return;
+    }
+#endif
+    auto const size = console_size();
+    if (not size.has_value() or (size->width == width() and size->height == height())) {
+        return;
+    }
+    resize(size->width, size->height);
+    m_encoder.write(ansi::clear_screen);
+    write_flushed(m_encoder, m_scrollback.render(width(), height()));
+}
+
+void AnsiTerminal::write_transition() {
+    auto skipped = m_pacing.mode == Pacing::Mode::Instant;
+    for (auto i = 0; i < 3; ++i) {
+        write_flushed(m_encoder, ".");
+        if (not skipped) {
+            skipped = wait_for_key(Clock::now() + m_pacing.transition_delay);
+        }
+    }
+}
+
+void AnsiTerminal::enter_alternate_screen_buffer() {
+    m_encoder.write("\033[?1049h");
+}
+
+void AnsiTerminal::exit_alternate_screen_buffer() {
+    m_encoder.write("\033[?1049l");
+}
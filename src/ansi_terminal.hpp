@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string_view>
+#include "ansi_encoder.hpp"
+#include "scrollback.hpp"
+#include "terminal.hpp"
+
+// Determines how fast printed text appears on the screen.
+struct Pacing final {
+    enum class Mode {
+        Typewriter,  // Character by character.
+        Lines,       // Line by line.
+        Instant,     // Everything at once.
+    };
+
+    Mode mode = Mode::Typewriter;
+    int characters_per_second = 50;
+    std::chrono::milliseconds line_delay{ 150 };
+    std::chrono::milliseconds transition_delay{ 200 };  // Between the dots printed by `Terminal::clear(true)`.
+
+    // Accepts "instant", "lines" or the number of characters per second for the typewriter mode.
+    [[nodiscard]] static Pacing parse(std::string_view text);
+};
+
+// Writes to the terminal the program is running in, using ANSI escape sequences. Since it takes over
+// the whole screen, there can only be one instance at a time.
+class AnsiTerminal final : public Terminal {
+private:
+    static inline std::atomic_bool s_initialized = false;
+    Pacing m_pacing;
+    bool m_is_screen;
+    Scrollback m_scrollback;
+    AnsiEncoder m_encoder;
+
+public:
+    explicit AnsiTerminal(InputSource& input);
+    ~AnsiTerminal() noexcept override;
+
+    [[nodiscard]] Pacing const& pacing() const {
+        return m_pacing;
+    }
+
+    void set_pacing(Pacing const& pacing) {
+        m_pacing = pacing;
+    }
+
+    [[nodiscard]] c2k::Utf8String read_line() override;
+
+private:
+    void write(std::string_view bytes) override;
+    void write_paragraph(StyledText const& text) override;
+    void write_clear() override;
+    void write_transition() override;
+    void apply_resize();
+    void enter_alternate_screen_buffer();
+    void exit_alternate_screen_buffer();
+};
@@ -0,0 +1,49 @@
+#include "builtin_words.hpp"
+#include <algorithm>
+#include <array>
+#include "builtin_word_tables.hpp"  // Generated at build time, see `word_tables.hpp`.
+
+namespace generated = builtin_words::generated;
+
+[[nodiscard]] static constexpr auto list_names() {
+    auto names = std::array<std::string_view, generated::synonym_lists.size()>{};
+    for (auto i = usize{ 0 }; i < names.size(); ++i) {
+        names.at(i) = generated::synonym_lists.at(i).name;
+    }
+    return names;
+}
+
+static constexpr auto synonym_list_name_array = list_names();
+
+namespace builtin_words {
+    [[nodiscard]] bool matches_synonym_lists(std::vector<RawFile> const& lists) {
+        if (lists.size() != generated::synonym_lists.size()) {
+            return false;
+        }
+        return std::all_of(lists.cbegin(), lists.cend(), [](RawFile const& list) {
+            return std::any_of(generated::synonym_lists.cbegin(), generated::synonym_lists.cend(), [&](List const builtin) {
+                return builtin.name == list.name.view() and builtin.content_hash == content_hash(list.contents.view());
+            });
+        });
+    }
+
+    [[nodiscard]] bool matches_ignore_list(c2k::Utf8StringView const contents) {
+        return content_hash(contents.view()) == generated::ignore_list_hash;
+    }
+
+    [[nodiscard]] std::span<std::string_view const> synonym_list_names() {
+        return synonym_list_name_array;
+    }
+
+    [[nodiscard]] u64 synonym_lists_of(std::string_view const word) {
+        return generated::synonym_table.find(word);
+    }
+
+    [[nodiscard]] std::span<std::pair<std::string_view, u64> const> synonyms() {
+        return generated::synonym_table.slots;
+    }
+
+    [[nodiscard]] bool is_ignored(std::string_view const word) {
+        return generated::ignore_table.find(word);
+    }
+}  // namespace builtin_words
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <lib2k/types.hpp>
+#include <lib2k/utf8/string_view.hpp>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "content.hpp"
+
+// Perfect hash tables for the synonym lists and the ignore list, generated at build time from the
+// content (see `word_tables.hpp`). They must only be used as long as the loaded lists are the ones
+// they have been generated from. Otherwise (e.g. for modded content), the tables built at runtime take
+// over. Only available if the `guess_what_builtin_words` option is enabled.
+namespace builtin_words {
+    struct List final {
+        std::string_view name;
+        u64 content_hash;
+    };
+
+    // FNV-1a with 64 bits. Only the hashes of the lists that the tables have been generated from are compiled
+    // into the game, which is enough to tell whether the loaded lists are the same.
+    [[nodiscard]] constexpr u64 content_hash(std::string_view const contents) {
+        auto result = u64{ 14695981039346656037u };
+        for (auto const c : contents) {
+            result = (result ^ static_cast<u8>(c)) * u64{ 1099511628211u };
+        }
+        return result;
+    }
+
+    [[nodiscard]] bool matches_synonym_lists(std::vector<RawFile> const& lists);
+    [[nodiscard]] bool matches_ignore_list(c2k::Utf8StringView contents);
+
+    // The names of the synonym lists, sorted.
+    [[nodiscard]] std::span<std::string_view const> synonym_list_names();
+
+    // Returns a mask with the bits of all synonym lists (by their index in `synonym_list_names()`)
+    // that contain the word.
+    [[nodiscard]] u64 synonym_lists_of(std::string_view word);
+
+    // Every word of the synonym lists, together with the mask of the lists that contain it.
+    [[nodiscard]] std::span<std::pair<std::string_view, u64> const> synonyms();
+
+    [[nodiscard]] bool is_ignored(std::string_view word);
+}  // namespace builtin_words
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <bit>
+#include <lib2k/types.hpp>
+#include <string_view>
+
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#define GUESS_WHAT_SSE2
+#include <emmintrin.h>
+#endif
+
+// GCC and Clang compile the AVX2 functions for every x86 target by enabling AVX2 for just these functions,
+// so that the rest of the program doesn't depend on it. Whether they may be called is decided at runtime.
+#if defined(__AVX2__)
+#define GUESS_WHAT_AVX2
+#define GUESS_WHAT_AVX2_FUNCTION
+#elif defined(GUESS_WHAT_SSE2) and (defined(__GNUC__) or defined(__clang__))
+#define GUESS_WHAT_AVX2
+#define GUESS_WHAT_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+#ifdef GUESS_WHAT_AVX2
+#include <immintrin.h>
+#endif
+
+// Vectorized byte scanning for the hot loops of the lexer. Each matcher knows how to classify a
+// single byte and a block of 16 bytes (SSE2) or 32 bytes (AVX2) at once. SSE2 is part of every x86-64
+// target, while AVX2 is only used if the CPU supports it. A scanner works through the input in blocks
+// of its size and then of the smaller sizes, so the scalar path handles the tail of the input and all
+// platforms without SSE2. All paths must always agree.
+namespace byte_scan {
+    namespace detail {
+        struct Equals final {
+            char byte;
+
+            [[nodiscard]] bool matches(char const c) const {
+                return c == byte;
+            }
+
+#ifdef GUESS_WHAT_SSE2
+            [[nodiscard]] __m128i matches(__m128i const block) const {
+                return _mm_cmpeq_epi8(block, _mm_set1_epi8(byte));
+            }
+#endif
+
+#ifdef GUESS_WHAT_AVX2
+            [[nodiscard]] GUESS_WHAT_AVX2_FUNCTION __m256i matches(__m256i const block) const {
+                return _mm256_cmpeq_epi8(block, _mm256_set1_epi8(byte));
+            }
+#endif
+        };
+
+        struct Differs final {
+            char byte;
+
+            [[nodiscard]] bool matches(char const c) const {
+                return c != byte;
+            }
+
+#ifdef GUESS_WHAT_SSE2
+            [[nodiscard]] __m128i matches(__m128i const block) const {
+                return _mm_xor_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(byte)), _mm_set1_epi8(-1));
+            }
+#endif
+
+#ifdef GUESS_WHAT_AVX2
+            [[nodiscard]] GUESS_WHAT_AVX2_FUNCTION __m256i matches(__m256i const block) const {
+                return _mm256_xor_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(byte)), _mm256_set1_epi8(-1));
+            }
+#endif
+        };
+
+        // Matches everything except ' ', '\t', '\v', '\f', '\r' and (unless `stop_at_linebreak`
+        // is set) '\n', i.e. the complement of `is_whitespace()`.
+        struct NotWhitespace final {
+            bool stop_at_linebreak;
+
+            [[nodiscard]] bool matches(char const c) const {
+                if (c == '\n') {
+                    return stop_at_linebreak;
+                }
+                return not(c == ' ' or (c >= '\t' and c <= '\r'));
+            }
+
+#ifdef GUESS_WHAT_SSE2
+            [[nodiscard]] __m128i matches(__m128i const block) const {
+                // '\t' to '\r' are contiguous, so a single unsigned range check covers them.
+                auto const offset = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+                auto const in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8('\r' - '\t')), offset);
+                auto whitespace = _mm_or_si128(in_range, _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')));
+                if (stop_at_linebreak) {
+                    whitespace = _mm_andnot_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), whitespace);
+                }
+                return _mm_xor_si128(whitespace, _mm_set1_epi8(-1));
+            }
+#endif
+
+#ifdef GUESS_WHAT_AVX2
+            [[nodiscard]] GUESS_WHAT_AVX2_FUNCTION __m256i matches(__m256i const block) const {
+                auto const offset = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+                auto const in_range =
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8('\r' - '\t')), offset);
+                auto whitespace = _mm256_or_si256(in_range, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')));
+                if (stop_at_linebreak) {
+                    whitespace = _mm256_andnot_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')), whitespace);
+                }
+                return _mm256_xor_si256(whitespace, _mm256_set1_epi8(-1));
+            }
+#endif
+        };
+
+        // Matches everything except ASCII letters, digits and '_', i.e. the bytes that end an identifier.
+        struct NotIdentifier final {
+            [[nodiscard]] bool matches(char const c) const {
+                return not((c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z') or (c >= '0' and c <= '9') or c == '_');
+            }
+
+#ifdef GUESS_WHAT_SSE2
+            [[nodiscard]] __m128i matches(__m128i const block) const {
+                // Setting bit 5 maps upper case letters to lower case ones and no other byte to a letter.
+                auto const letter_offset = _mm_sub_epi8(_mm_or_si128(block, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+                auto const letter =
+                    _mm_cmpeq_epi8(_mm_min_epu8(letter_offset, _mm_set1_epi8('z' - 'a')), letter_offset);
+                auto const digit_offset = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+                auto const digit = _mm_cmpeq_epi8(_mm_min_epu8(digit_offset, _mm_set1_epi8('9' - '0')), digit_offset);
+                auto const underscore = _mm_cmpeq_epi8(block, _mm_set1_epi8('_'));
+                return _mm_xor_si128(_mm_or_si128(_mm_or_si128(letter, digit), underscore), _mm_set1_epi8(-1));
+            }
+#endif
+
+#ifdef GUESS_WHAT_AVX2
+            [[nodiscard]] GUESS_WHAT_AVX2_FUNCTION __m256i matches(__m256i const block) const {
+                auto const letter_offset =
+                    _mm256_sub_epi8(_mm256_or_si256(block, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+                auto const letter =
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(letter_offset, _mm256_set1_epi8('z' - 'a')), letter_offset);
+                auto const digit_offset = _mm256_sub_epi8(block, _mm256_set1_epi8('0'));
+                auto const digit =
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(digit_offset, _mm256_set1_epi8('9' - '0')), digit_offset);
+                auto const underscore = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_'));
+                return _mm256_xor_si256(
+                    _mm256_or_si256(_mm256_or_si256(letter, digit), underscore),
+                    _mm256_set1_epi8(-1)
+                );
+            }
+#endif
+        };
+
+        template<typename Matcher>
+        [[nodiscard]] usize find_first_scalar(std::string_view const text, usize position, Matcher const& matcher) {
+            for (; position < text.size(); ++position) {
+                if (matcher.matches(text[position])) {
+                    return position;
+                }
+            }
+            return text.size();
+        }
+
+        template<typename Matcher>
+        [[nodiscard]] usize find_last_scalar(std::string_view const text, usize end, Matcher const& matcher) {
+            while (end > 0) {
+                --end;
+                if (matcher.matches(text[end])) {
+                    return end;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+#ifdef GUESS_WHAT_SSE2
+        template<typename Matcher>
+        [[nodiscard]] usize find_first_sse2(std::string_view const text, usize position, Matcher const& matcher) {
+            for (; position + 16 <= text.size(); position += 16) {
+                auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(text.data() + position));
+                auto const mask = static_cast<u32>(_mm_movemask_epi8(matcher.matches(block)));
+                if (mask != 0) {
+                    return position + static_cast<usize>(std::countr_zero(mask));
+                }
+            }
+            return find_first_scalar(text, position, matcher);
+        }
+
+        template<typename Matcher>
+        [[nodiscard]] usize find_last_sse2(std::string_view const text, usize end, Matcher const& matcher) {
+            for (; end >= 16; end -= 16) {
+                auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(text.data() + end - 16));
+                auto const mask = static_cast<u32>(_mm_movemask_epi8(matcher.matches(block)));
+                if (mask != 0) {
+                    return end - 16 + static_cast<usize>(std::bit_width(mask)) - 1;
+                }
+            }
+            return find_last_scalar(text, end, matcher);
+        }
+#endif
+
+#ifdef GUESS_WHAT_AVX2
+        template<typename Matcher>
+        [[nodiscard]] GUESS_WHAT_AVX2_FUNCTION usize
+        find_first_avx2(std::string_view const text, usize position, Matcher const& matcher) {
+            for (; position + 32 <= text.size(); position += 32) {
+                auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(text.data() + position));
+                auto const mask = static_cast<u32>(_mm256_movemask_epi8(matcher.matches(block)));
+                if (mask != 0) {
+                    return position + static_cast<usize>(std::countr_zero(mask));
+                }
+            }
+            return find_first_sse2(text, position, matcher);
+        }
+
+        template<typename Matcher>
+        [[nodiscard]] GUESS_WHAT_AVX2_FUNCTION usize
+        find_last_avx2(std::string_view const text, usize end, Matcher const& matcher) {
+            for (; end >= 32; end -= 32) {
+                auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(text.data() + end - 32));
+                auto const mask = static_cast<u32>(_mm256_movemask_epi8(matcher.matches(block)));
+                if (mask != 0) {
+                    return end - 32 + static_cast<usize>(std::bit_width(mask)) - 1;
+                }
+            }
+            return find_last_sse2(text, end, matcher);
+        }
+
+        [[nodiscard]] inline bool cpu_supports_avx2() {
+#ifdef __AVX2__
+            return true;
+#else
+            static auto const supported = __builtin_cpu_supports("avx2") != 0;
+            return supported;
+#endif
+        }
+#endif
+
+        template<usize block_size, typename Matcher>
+        [[nodiscard]] usize find_first(std::string_view const text, usize const position, Matcher const& matcher) {
+#ifdef GUESS_WHAT_AVX2
+            if constexpr (block_size == 32) {
+                return find_first_avx2(text, position, matcher);
+            }
+#endif
+#ifdef GUESS_WHAT_SSE2
+            if constexpr (block_size == 16) {
+                return find_first_sse2(text, position, matcher);
+            }
+#endif
+            return find_first_scalar(text, position, matcher);
+        }
+
+        template<usize block_size, typename Matcher>
+        [[nodiscard]] usize find_last(std::string_view const text, Matcher const& matcher) {
+#ifdef GUESS_WHAT_AVX2
+            if constexpr (block_size == 32) {
+                return find_last_avx2(text, text.size(), matcher);
+            }
+#endif
+#ifdef GUESS_WHAT_SSE2
+            if constexpr (block_size == 16) {
+                return find_last_sse2(text, text.size(), matcher);
+            }
+#endif
+            return find_last_scalar(text, text.size(), matcher);
+        }
+
+        [[nodiscard]] constexpr bool is_supported_block_size(usize const block_size) {
+#ifdef GUESS_WHAT_AVX2
+            if (block_size == 32) {
+                return true;
+            }
+#endif
+#ifdef GUESS_WHAT_SSE2
+            if (block_size == 16) {
+                return true;
+            }
+#endif
+            return block_size == 1;
+        }
+    }  // namespace detail
+
+    // All functions taking a starting position return the position of the first matching byte at
+    // or after it, or the size of the text if there is none.
+    template<usize block_size>
+    struct Scanner final {
+        static_assert(detail::is_supported_block_size(block_size), "The target doesn't support this block size.");
+
+        [[nodiscard]] static usize find(std::string_view const text, usize const from, char const byte) {
+            return detail::find_first<block_size>(text, from, detail::Equals{ byte });
+        }
+
+        [[nodiscard]] static usize skip(std::string_view const text, usize const from, char const byte) {
+            return detail::find_first<block_size>(text, from, detail::Differs{ byte });
+        }
+
+        [[nodiscard]] static usize skip_whitespace(std::string_view const text, usize const from) {
+            return detail::find_first<block_size>(text, from, detail::NotWhitespace{ false });
+        }
+
+        // Like `skip_whitespace()`, but stops at linebreaks.
+        [[nodiscard]] static usize skip_blanks(std::string_view const text, usize const from) {
+            return detail::find_first<block_size>(text, from, detail::NotWhitespace{ true });
+        }
+
+        // Skips the rest of an identifier. Identifiers end at a structural byte (':', ',' or a linebreak),
+        // at whitespace or at the start of a comment or string.
+        [[nodiscard]] static usize skip_identifier(std::string_view const text, usize const from) {
+            return detail::find_first<block_size>(text, from, detail::NotIdentifier{});
+        }
+
+        // Returns the position of the last occurrence of `byte`, or `npos` if there is none.
+        [[nodiscard]] static usize find_last(std::string_view const text, char const byte) {
+            return detail::find_last<block_size>(text, detail::Equals{ byte });
+        }
+    };
+
+    using ScalarScanner = Scanner<1>;
+#ifdef GUESS_WHAT_SSE2
+    using Sse2Scanner = Scanner<16>;
+#endif
+#ifdef GUESS_WHAT_AVX2
+    // Must only be used if `cpu_supports_avx2()` is true.
+    using Avx2Scanner = Scanner<32>;
+
+    [[nodiscard]] inline bool cpu_supports_avx2() {
+        return detail::cpu_supports_avx2();
+    }
+
+    // Uses the AVX2 scanner if the CPU supports it and the SSE2 scanner otherwise.
+    struct DispatchingScanner final {
+        [[nodiscard]] static usize find(std::string_view const text, usize const from, char const byte) {
+            return cpu_supports_avx2() ? Avx2Scanner::find(text, from, byte) : Sse2Scanner::find(text, from, byte);
+        }
+
+        [[nodiscard]] static usize skip(std::string_view const text, usize const from, char const byte) {
+            return cpu_supports_avx2() ? Avx2Scanner::skip(text, from, byte) : Sse2Scanner::skip(text, from, byte);
+        }
+
+        [[nodiscard]] static usize skip_whitespace(std::string_view const text, usize const from) {
+            return cpu_supports_avx2() ? Avx2Scanner::skip_whitespace(text, from)
+                                       : Sse2Scanner::skip_whitespace(text, from);
+        }
+
+        [[nodiscard]] static usize skip_blanks(std::string_view const text, usize const from) {
+            return cpu_supports_avx2() ? Avx2Scanner::skip_blanks(text, from) : Sse2Scanner::skip_blanks(text, from);
+        }
+
+        [[nodiscard]] static usize skip_identifier(std::string_view const text, usize const from) {
+            return cpu_supports_avx2() ? Avx2Scanner::skip_identifier(text, from)
+                                       : Sse2Scanner::skip_identifier(text, from);
+        }
+
+        [[nodiscard]] static usize find_last(std::string_view const text, char const byte) {
+            return cpu_supports_avx2() ? Avx2Scanner::find_last(text, byte) : Sse2Scanner::find_last(text, byte);
+        }
+    };
+#endif
+
+#if defined(__AVX2__)
+    using FastestScanner = Avx2Scanner;
+#elif defined(GUESS_WHAT_AVX2)
+    using FastestScanner = DispatchingScanner;
+#elif defined(GUESS_WHAT_SSE2)
+    using FastestScanner = Sse2Scanner;
+#else
+    using FastestScanner = ScalarScanner;
+#endif
+}  // namespace byte_scan
@@ -0,0 +1,145 @@
+#include "content.hpp"
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <variant>
+#include "file_parser.hpp"
+#include "parallel.hpp"
+#include "utils.hpp"
+
+struct ContentDirectory final {
+    char const* directory;
+    char const* extension;
+    ContentKind kind;
+};
+
+static constexpr auto directories = std::array{
+    ContentDirectory{    "items",   ".item",     ContentKind::Item },
+    ContentDirectory{    "rooms",   ".room",     ContentKind::Room },
+    ContentDirectory{  "dialogs", ".dialog",   ContentKind::Dialog },
+    ContentDirectory{    "texts",    ".txt",     ContentKind::Text },
+    ContentDirectory{ "synonyms",   ".list", ContentKind::Synonyms },
+    ContentDirectory{    "lists",   ".list",     ContentKind::List },
+};
+
+[[nodiscard]] RawFile const& Content::list(c2k::Utf8StringView const name) const {
+    auto const find_iterator =
+        std::find_if(lists.cbegin(), lists.cend(), [&](auto const& list) { return list.name == name; });
+    if (find_iterator == lists.cend()) {
+        throw std::runtime_error{ "List \"" + std::string{ name.view() } + "\" not found." };
+    }
+    return *find_iterator;
+}
+
+[[nodiscard]] std::vector<SourceFile> collect_source_files() {
+    using DirectoryIterator = std::filesystem::recursive_directory_iterator;
+    auto sources = std::vector<SourceFile>{};
+    for (auto const& [directory, extension, kind] : directories) {
+        for (auto const& entry : DirectoryIterator{ directory }) {
+            if (entry.path().extension() != extension) {
+                continue;
+            }
+            sources.push_back(SourceFile{ entry.path(), kind });
+        }
+    }
+    // The directory iteration order is unspecified, but the content (and its error messages)
+    // should not depend on it.
+    std::sort(sources.begin(), sources.end(), [](auto const& lhs, auto const& rhs) { return lhs.path < rhs.path; });
+    return sources;
+}
+
+[[nodiscard]] std::vector<std::filesystem::path> content_directories() {
+    auto result = std::vector<std::filesystem::path>{};
+    for (auto const& content_directory : directories) {
+        result.emplace_back(content_directory.directory);
+    }
+    return result;
+}
+
+[[nodiscard]] std::optional<SourceFile> classify_source_file(std::filesystem::path const& path) {
+    auto const relative_path = path.lexically_normal();
+    if (relative_path.empty()) {
+        return std::nullopt;
+    }
+    for (auto const& [directory, extension, kind] : directories) {
+        if (*relative_path.begin() == directory and relative_path.extension() == extension) {
+            return SourceFile{ relative_path, kind };
+        }
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] ParsedFile load_parsed_file(SourceFile const& source) {
+    return ParsedFile{ c2k::Utf8String{ source.path.stem().string() }, File{ source.path }.document() };
+}
+
+[[nodiscard]] RawFile load_raw_file(SourceFile const& source) {
+    return RawFile{ c2k::Utf8String{ source.path.stem().string() }, read_file(source.path) };
+}
+
+using LoadedFile = std::variant<std::monostate, ParsedFile, RawFile>;
+
+[[nodiscard]] static LoadedFile load_file(SourceFile const& source) {
+    switch (source.kind) {
+        case ContentKind::Item:
+        case ContentKind::Room:
+        case ContentKind::Dialog:
+            return load_parsed_file(source);
+        case ContentKind::Text:
+        case ContentKind::Synonyms:
+        case ContentKind::List:
+            return load_raw_file(source);
+    }
+    throw std::runtime_error{ "Unknown content kind." };
+}
+
+[[nodiscard]] Content load_content(std::vector<SourceFile> const& sources) {
+    // Reading, lexing and parsing of the individual files is independent, so it's done in parallel.
+    auto loaded_files = std::vector<LoadedFile>(sources.size());
+    auto errors = std::vector<std::exception_ptr>(sources.size());
+    parallel_for(sources.size(), [&](usize const index) {
+        try {
+            loaded_files.at(index) = load_file(sources.at(index));
+        } catch (...) {
+            errors.at(index) = std::current_exception();
+        }
+    });
+
+    // Report the error of the first failing file (in path order), regardless of which thread failed first.
+    for (auto i = usize{ 0 }; i < sources.size(); ++i) {
+        if (errors.at(i) == nullptr) {
+            continue;
+        }
+        try {
+            std::rethrow_exception(errors.at(i));
+        } catch (std::exception const& exception) {
+            throw std::runtime_error{ sources.at(i).path.string() + ": " + exception.what() };
+        }
+    }
+
+    auto content = Content{};
+    for (auto i = usize{ 0 }; i < sources.size(); ++i) {
+        auto& file = loaded_files.at(i);
+        switch (sources.at(i).kind) {
+            case ContentKind::Item:
+                content.items.push_back(std::get<ParsedFile>(std::move(file)));
+                break;
+            case ContentKind::Room:
+                content.rooms.push_back(std::get<ParsedFile>(std::move(file)));
+                break;
+            case ContentKind::Dialog:
+                content.dialogs.push_back(std::get<ParsedFile>(std::move(file)));
+                break;
+            case ContentKind::Text:
+                content.texts.push_back(std::get<RawFile>(std::move(file)));
+                break;
+            case ContentKind::Synonyms:
+                content.synonyms.push_back(std::get<RawFile>(std::move(file)));
+                break;
+            case ContentKind::List:
+                content.lists.push_back(std::get<RawFile>(std::move(file)));
+                break;
+        }
+    }
+    return content;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <lib2k/types.hpp>
+#include <optional>
+#include <lib2k/utf8/string.hpp>
+#include <vector>
+#include "entry.hpp"
+
+enum class ContentKind : u32 {
+    Item,
+    Room,
+    Dialog,
+    Text,
+    Synonyms,
+    List,
+};
+
+struct SourceFile final {
+    std::filesystem::path path;
+    ContentKind kind;
+};
+
+// A content file that has been run through the lexer and the file parser.
+struct ParsedFile final {
+    c2k::Utf8String name;
+    Document document;
+};
+
+// A content file that is used verbatim (texts and word lists).
+struct RawFile final {
+    c2k::Utf8String name;
+    c2k::Utf8String contents;
+};
+
+// All game content, either read from the text sources or from a compiled world image.
+struct Content final {
+    std::vector<ParsedFile> items;
+    std::vector<ParsedFile> rooms;
+    std::vector<ParsedFile> dialogs;
+    std::vector<RawFile> texts;
+    std::vector<RawFile> synonyms;
+    std::vector<RawFile> lists;
+
+    [[nodiscard]] RawFile const& list(c2k::Utf8StringView name) const;
+};
+
+// Returns all content source files, sorted by path.
+[[nodiscard]] std::vector<SourceFile> collect_source_files();
+
+// Returns the directories that contain the content source files.
+[[nodiscard]] std::vector<std::filesystem::path> content_directories();
+
+// Determines the kind of a content file from its location, or returns nothing if the path
+// doesn't belong to the content.
+[[nodiscard]] std::optional<SourceFile> classify_source_file(std::filesystem::path const& path);
+
+[[nodiscard]] ParsedFile load_parsed_file(SourceFile const& source);
+[[nodiscard]] RawFile load_raw_file(SourceFile const& source);
+
+[[nodiscard]] Content load_content(std::vector<SourceFile> const& sources);
@@ -0,0 +1,88 @@
+#include "content_watcher.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Editors either write files in place or write a temporary file and rename it afterwards. Files that
+// are deleted or moved away are reported as well.
+static constexpr auto watched_events = u32{ IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM };
+
+ContentWatcher::ContentWatcher()
+    : m_descriptor{ inotify_init1(IN_NONBLOCK | IN_CLOEXEC) } {
+    if (m_descriptor < 0) {
+        throw std::runtime_error{ "Unable to initialize inotify." };
+    }
+    // inotify doesn't watch directories recursively, so every subdirectory needs its own watch.
+    auto const add_watch = [this](std::filesystem::path const& directory) {
+        auto const watch = inotify_add_watch(m_descriptor, directory.c_str(), watched_events);
+        if (watch < 0) {
+            throw std::runtime_error{ "Unable to watch directory: " + directory.string() };
+        }
+        m_directories.emplace(watch, directory);
+    };
+    for (auto const& directory : content_directories()) {
+        add_watch(directory);
+        for (auto const& entry : std::filesystem::recursive_directory_iterator{ directory }) {
+            if (entry.is_directory()) {
+                add_watch(entry.path());
+            }
+        }
+    }
+}
+
+ContentWatcher::~ContentWatcher() noexcept {
+    close(m_descriptor);
+}
+
+[[nodiscard]] std::vector<SourceFile> ContentWatcher::changed_files() {
+    auto changed = std::vector<SourceFile>{};
+    alignas(inotify_event) auto buffer = std::array<char, 4096>{};
+    while (true) {
+        auto const length = read(m_descriptor, buffer.data(), buffer.size());
+        if (length < 0 and errno == EAGAIN) {
+            break;
+        }
+        if (length <= 0) {
+            throw std::runtime_error{ "Failed to read inotify events." };
+        }
+        for (auto offset = usize{ 0 }; offset < static_cast<usize>(length);) {
+            auto const& event = *reinterpret_cast<inotify_event const*>(buffer.data() + offset);
+            offset += sizeof(inotify_event) + event.len;
+            auto const directory = m_directories.find(event.wd);
+            if (event.len == 0 or directory == m_directories.cend()) {
+                continue;
+            }
+            auto source = classify_source_file(directory->second / event.name);
+            if (not source.has_value()) {
+                continue;
+            }
+            auto const already_reported = std::any_of(changed.cbegin(), changed.cend(), [&](auto const& other) {
+                return other.path == source->path;
+            });
+            if (not already_reported) {
+                changed.push_back(std::move(source).value());
+            }
+        }
+    }
+    return changed;
+}
+
+#else
+
+ContentWatcher::ContentWatcher() {
+    throw std::runtime_error{ "Watching content files is only supported on Linux." };
+}
+
+ContentWatcher::~ContentWatcher() noexcept = default;
+
+[[nodiscard]] std::vector<SourceFile> ContentWatcher::changed_files() {
+    return {};
+}
+
+#endif
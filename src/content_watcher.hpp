@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+#include "content.hpp"
+
+// Reports content files that have been written to or deleted since the last call to `changed_files()`.
+// Watching is based on inotify and therefore only supported on Linux.
+class ContentWatcher final {
+private:
+    int m_descriptor = -1;
+    std::unordered_map<int, std::filesystem::path> m_directories;  // By watch descriptor.
+
+public:
+    ContentWatcher();
+
+    ContentWatcher(ContentWatcher const& other) = delete;
+    ContentWatcher(ContentWatcher&& other) noexcept = delete;
+    ContentWatcher& operator=(ContentWatcher const& other) = delete;
+    ContentWatcher& operator=(ContentWatcher&& other) noexcept = delete;
+
+    ~ContentWatcher() noexcept;
+
+    // Does not block. Every file is only reported once, even if it has been written to multiple times.
+    [[nodiscard]] std::vector<SourceFile> changed_files();
+};
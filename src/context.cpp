@@ -0,0 +1,47 @@
+#include "context.hpp"
+#include "world.hpp"
+
+void Context::remove_item(Item* const item) const {
+    m_world->remove_item(item);
+}
+
+[[nodiscard]] Item* Context::find_item(Symbol const reference) const {
+    // The inventories are searched directly instead of collecting the available items up front,
+    // so that the search always sees the effects of previous instructions.
+    auto const find_in = [&](Inventory const& inventory) -> Item* {
+        for (auto const& item : inventory) {
+            if (item != nullptr and item->blueprint().reference() == reference) {
+                return item.get();
+            }
+        }
+        return nullptr;
+    };
+    if (auto const item = find_in(m_world->m_current_room->inventory())) {
+        return item;
+    }
+    return find_in(m_world->m_inventory);
+}
+
+void Context::spawn_item(Symbol const reference, SpawnLocation const location) const {
+    m_world->spawn_item(reference, location);
+}
+
+[[nodiscard]] FlagSet& Context::flags() const {
+    return m_world->m_flags;
+}
+
+void Context::goto_room(Symbol const room_reference) const {
+    m_world->enter(m_world->find_room_by_reference(room_reference), *m_terminal);
+}
+
+void Context::start_dialog(Symbol const dialog_reference) const {
+    m_dialog_database->run_dialog(dialog_reference, *m_terminal, m_world->m_flags, [this](Symbol const reference) {
+        return m_world->has_item(reference);
+    });
+}
+
+void Context::win() const {
+    m_terminal->clear(true);
+    m_text_database->get("win").print(*m_terminal);
+    m_world->m_running = false;
+}
@@ -4,29 +4,27 @@
 #include "file_parser.hpp"
 #include "utils.hpp"
 
-Dialog::Dialog(std::filesystem::path const& path) {
-    auto const file = read_file(path);
-    auto const tree = FileParser{ Lexer{ file }.tokenize() }.parse();
-
+Dialog::Dialog(Tree const tree) {
     auto start_found = false;
-    m_speaker = tree.fetch<String>("speaker");
+    // Everything that's printed is styled once here instead of every time the dialog runs.
+    auto const speaker = c2k::Utf8String{ tree.fetch<String>("speaker") };
     for (auto const& [label_name, sub_tree] : tree.fetch<Tree>("labels")) {
-        if (not sub_tree->is_tree()) {
+        if (not sub_tree.is_tree()) {
             throw std::runtime_error{ "Label must be defined as tree." };
         }
-        auto const& label_tree = sub_tree->as_tree();
-        auto text = label_tree.fetch<String>("text");
+        auto const label_tree = sub_tree.as_tree();
+        auto text = StyledText{ speaker + ": " + c2k::Utf8String{ label_tree.fetch<String>("text") } };
         auto choices = std::vector<Choice>{};
-        for (auto const& [choice_key, choice_sub_tree] : label_tree.entries()) {
+        for (auto const& [choice_key, choice_sub_tree] : label_tree) {
             if (choice_key != "choice") {
                 continue;
             }
-            if (not choice_sub_tree->is_tree()) {
+            if (not choice_sub_tree.is_tree()) {
                 throw std::runtime_error{ "Choice must be defined as tree." };
             }
-            auto const& choice_tree = choice_sub_tree->as_tree();
-            auto prompt = choice_tree.fetch<String>("prompt");
-            auto choice_text = choice_tree.fetch<String>("text");
+            auto const choice_tree = choice_sub_tree.as_tree();
+            auto prompt = StyledText{ choice_tree.fetch<String>("prompt") };
+            auto choice_text = StyledText{ "*Ich*: " + c2k::Utf8String{ choice_tree.fetch<String>("text") } };
             auto required_items = choice_tree.try_fetch<IdentifierList>("required_items");
             auto defines = choice_tree.try_fetch<IdentifierList>("define");
             auto goto_target_reference = choice_tree.try_fetch<IdentifierList>("goto");
@@ -36,20 +34,24 @@ Dialog::Dialog(std::filesystem::path const& path) {
             if (goto_target_reference.has_value() and goto_target_reference->size() != 1) {
                 throw std::runtime_error{ "Goto target must be a single identifier." };
             }
-            auto goto_target = goto_target_reference.map([](auto const& identifiers) { return identifiers.front(); });
+            auto goto_target = goto_target_reference.map([](auto const& identifiers) {
+                return Symbol{ identifiers.front() };
+            });
             choices.emplace_back(
                 std::move(prompt),
                 std::move(choice_text),
-                required_items.value_or(std::vector<c2k::Utf8String>{}),
-                defines.value_or(std::vector<c2k::Utf8String>{}),
-                std::move(goto_target)
+                required_items.map([](auto const& identifiers) { return intern_all(identifiers); })
+                    .value_or(std::vector<Symbol>{}),
+                defines.map([](auto const& identifiers) { return FlagSet::of(intern_all(identifiers)); })
+                    .value_or(FlagSet{}),
+                goto_target
             );
         }
 
         if (label_name == "start") {
             start_found = true;
         }
-        m_labels.emplace(label_name, Label{ std::move(text), std::move(choices) });
+        m_labels.emplace(Symbol{ label_name }, Label{ std::move(text), std::move(choices) });
     }
     if (not start_found) {
         throw std::runtime_error{ "Dialog must have a \"start\" label." };
@@ -70,13 +72,13 @@ usize Dialog::read_choice(Terminal& terminal, usize const size) const {
 
 void Dialog::run(
     Terminal& terminal,
-    std::function<void(c2k::Utf8StringView)> const& define,
-    std::function<bool(c2k::Utf8StringView)> const& has_item
+    FlagSet& flags,
+    std::function<bool(Symbol)> const& has_item
 ) const {
-    auto current_label = c2k::Utf8String{ "start" };
+    auto current_label = Symbol{ "start" };
     while (true) {
         auto const& label = m_labels.at(current_label);
-        terminal.println(m_speaker.operator+(": ").operator+(label.text));
+        terminal.println(label.text);
 
         auto possible_choices = std::vector<Choice const*>{};
 
@@ -93,16 +95,17 @@ void Dialog::run(
             }
         }
 
+        // Prompts are short enough to fit on a line together with their number, so the number doesn't
+        // have to be part of the wrapped text.
         for (auto i = usize{ 0 }; i < possible_choices.size(); ++i) {
-            terminal.println(std::to_string(i + 1) + ". " + possible_choices.at(i)->prompt);
+            terminal.print_raw(c2k::Utf8String{ std::to_string(i + 1) + ". " });
+            terminal.println(possible_choices.at(i)->prompt);
         }
 
         auto const choice_index = read_choice(terminal, possible_choices.size());
         auto const& choice = *possible_choices.at(choice_index);
-        terminal.println("*Ich*: " + choice.text);
-        for (auto const& define_identifier : choice.defines) {
-            define(define_identifier);
-        }
+        terminal.println(choice.text);
+        flags.insert(choice.defines);
         if (choice.goto_target_reference.has_value()) {
             current_label = choice.goto_target_reference.value();
         } else {
@@ -1,20 +1,20 @@
 #include "dialog_database.hpp"
 
-DialogDatabase::DialogDatabase() {
-    using DirectoryIterator = std::filesystem::recursive_directory_iterator;
-    for (auto const& entry : DirectoryIterator{ dialogs_directory }) {
-        if (entry.path().extension() != ".dialog") {
-            continue;
-        }
-        m_dialogs.emplace(entry.path().stem().string(), Dialog{ entry.path() });
+DialogDatabase::DialogDatabase(Content const& content) {
+    for (auto const& [name, document] : content.dialogs) {
+        m_dialogs.emplace(Symbol{ name }, Dialog{ document.root() });
     }
 }
 
+void DialogDatabase::reload(ParsedFile const& file) {
+    m_dialogs.insert_or_assign(Symbol{ file.name }, Dialog{ file.document.root() });
+}
+
 void DialogDatabase::run_dialog(
-    c2k::Utf8StringView const name,
+    Symbol const name,
     Terminal& terminal,
-    std::function<void(c2k::Utf8StringView)> const& define,
-    std::function<bool(c2k::Utf8StringView)> const& has_item
+    FlagSet& flags,
+    std::function<bool(Symbol)> const& has_item
 ) const {
-    m_dialogs.at(name).run(terminal, define, has_item);
+    m_dialogs.at(name).run(terminal, flags, has_item);
 }
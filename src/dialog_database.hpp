@@ -1,22 +1,29 @@
 #pragma once
 
-#include <filesystem>
 #include <lib2k/utf8/string.hpp>
 #include <unordered_map>
+#include "content.hpp"
 #include "dialog.hpp"
+#include "symbol.hpp"
 
 class DialogDatabase {
 private:
-    static constexpr auto dialogs_directory = "dialogs";
-
-    std::unordered_map<c2k::Utf8String, Dialog> m_dialogs;
+    std::unordered_map<Symbol, Dialog> m_dialogs;
 
 public:
-    DialogDatabase();
+    explicit DialogDatabase(Content const& content);
+
+    // Replaces (or adds) a single dialog. If the new version is invalid, the old one is kept.
+    void reload(ParsedFile const& file);
+
+    [[nodiscard]] bool contains(Symbol const name) const {
+        return m_dialogs.contains(name);
+    }
+
     void run_dialog(
-        c2k::Utf8StringView name,
+        Symbol name,
         Terminal& terminal,
-        std::function<void(c2k::Utf8StringView)> const& define,
-        std::function<bool(c2k::Utf8StringView)> const& has_item
+        FlagSet& flags,
+        std::function<bool(Symbol)> const& has_item
     ) const;
 };
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+// Returns the world image that has been compiled at build time and embedded into the executable.
+// Only available if the `guess_what_embed_world` option is enabled.
+[[nodiscard]] std::span<std::byte const> embedded_world_image();
@@ -1,247 +1,519 @@
 #pragma once
 
+#include <concepts>
+#include <iterator>
+#include <limits>
 #include <lib2k/types.hpp>
 #include <lib2k/utf8/string.hpp>
 #include <lib2k/utf8/string_view.hpp>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <tl/optional.hpp>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+class Entry;
 class Tree;
-class String;
 class IdentifierList;
-class Reference;
 
-class Entry {
-public:
-    Entry() = default;
-    Entry(Entry const& other) = default;
-    Entry(Entry&& other) noexcept = default;
-    Entry& operator=(Entry const& other) = default;
-    Entry& operator=(Entry&& other) noexcept = default;
-    virtual ~Entry() = default;
+enum class EntryKind : u8 {
+    Tree,
+    String,
+    IdentifierList,
+    Reference,
+};
 
-    [[nodiscard]] virtual bool is_tree() const {
-        return false;
-    }
+// Parsed documents are stored flat: all nodes of a document live in a single array and refer to
+// their children, identifiers and strings by index. Strings are interned per document.
+struct Node final {
+    EntryKind kind;
+    u32 key;    // Index into the strings of the document.
+    u32 first;  // Tree: first child node. String: index of the string. IdentifierList: first identifier.
+    u32 count;  // Tree: number of children. IdentifierList: number of identifiers.
+};
 
-    [[nodiscard]] virtual bool is_string() const {
-        return false;
-    }
+// Trees with at least this many children get a key index, smaller trees are searched linearly.
+inline constexpr auto indexed_tree_threshold = usize{ 16 };
 
-    [[nodiscard]] virtual bool is_identifier_list() const {
-        return false;
-    }
+// Maps the keys of a tree to its children with that key. Keys may repeat, so every key maps to a
+// range of child node indices, which are stored in document order.
+struct TreeIndex final {
+    struct Range final {
+        u32 first;
+        u32 count;
+    };
 
-    [[nodiscard]] virtual bool is_reference() const {
-        return false;
-    }
+    std::unordered_map<std::string_view, Range> keys;  // The views refer to the strings of the document.
+    std::vector<u32> children;
 
-    [[nodiscard]] virtual Tree const& as_tree() const;
-    [[nodiscard]] virtual String const& as_string() const;
-    [[nodiscard]] virtual IdentifierList const& as_identifier_list() const;
-    [[nodiscard]] virtual Reference const& as_reference() const;
-    [[nodiscard]] virtual char const* type_name() const = 0;
+    [[nodiscard]] std::span<u32 const> find(std::string_view const key) const {
+        auto const find_iterator = keys.find(key);
+        if (find_iterator == keys.cend()) {
+            return {};
+        }
+        return std::span{ children }.subspan(find_iterator->second.first, find_iterator->second.count);
+    }
+};
 
-    [[nodiscard]] virtual c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const = 0;
+struct DocumentStorage final {
+    std::vector<Node> nodes;  // The root tree is always the first node.
+    std::vector<u32> identifiers;
+    std::vector<c2k::Utf8String> strings;
+    std::unordered_map<u32, TreeIndex> indices;  // Key indices of all large trees, by node index.
 };
 
-class Tree final : public Entry {
+// Owns all nodes of a parsed file. `Tree`, `Entry` and `IdentifierList` are non-owning handles into
+// a document and stay valid as long as any copy of the document exists. Documents are immutable, so
+// copies share their storage.
+class Document final {
+private:
+    std::shared_ptr<DocumentStorage const> m_storage;
+
 public:
-    using Dict = std::vector<std::pair<c2k::Utf8String, std::unique_ptr<Entry>>>;
-    using ValueType = Dict;
+    explicit Document(std::unique_ptr<DocumentStorage> storage)
+        : m_storage{ std::move(storage) } {}
 
+    [[nodiscard]] Tree root() const;
+};
+
+// Builds a document bottom-up. Children are collected on a stack until their parent tree is closed
+// and then moved into the node array, so the children of a tree are always contiguous.
+class DocumentBuilder final {
 private:
-    Dict m_entries;
+    std::unique_ptr<DocumentStorage> m_storage = std::make_unique<DocumentStorage>();
+    std::unordered_map<std::string_view, u32> m_string_indices;
+    std::vector<Node> m_pending;
 
 public:
-    explicit Tree(Dict entries)
-        : m_entries{ std::move(entries) } {}
-
-    [[nodiscard]] bool is_tree() const override {
-        return true;
+    DocumentBuilder() {
+        m_storage->nodes.push_back(Node{ EntryKind::Tree, string(""), 0, 0 });
     }
 
-    [[nodiscard]] c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const override;
+    // The bytes of all strings passed to the builder must stay alive until `finish()` is called.
+    void add_string(std::string_view const key, std::string_view const value) {
+        m_pending.push_back(Node{ EntryKind::String, string(key), string(value), 0 });
+    }
 
-    template<std::derived_from<Entry> T>
-    [[nodiscard]] auto try_fetch(c2k::Utf8StringView key) const -> tl::optional<typename T::ValueType const&>;
+    void add_reference(std::string_view const key) {
+        m_pending.push_back(Node{ EntryKind::Reference, string(key), 0, 0 });
+    }
 
-    template<std::derived_from<Entry> T>
-    [[nodiscard]] auto fetch(c2k::Utf8StringView const key) const -> typename T::ValueType const& {
-        auto result = try_fetch<T>(key);
-        if (not result.has_value()) {
-            throw std::runtime_error{ "Required key \"" + std::string{ key.view() } + "\" not found or type mismatch." };
+    template<std::ranges::input_range Range>
+    void add_identifier_list(std::string_view const key, Range const& identifiers) {
+        auto const first = narrow(m_storage->identifiers.size());
+        for (auto const& identifier : identifiers) {
+            m_storage->identifiers.push_back(string(identifier));
         }
-        return std::move(result).value();
+        m_pending.push_back(Node{ EntryKind::IdentifierList,
+                                  string(key),
+                                  first,
+                                  narrow(m_storage->identifiers.size() - first) });
     }
 
-    template<std::derived_from<Entry> T>
-    [[nodiscard]] auto fetch_all(c2k::Utf8StringView const key) const -> std::vector<typename T::ValueType const*>;
+    // Returns a marker that has to be passed to `close_tree()` after all children have been added.
+    [[nodiscard]] usize open_tree() const {
+        return m_pending.size();
+    }
 
-    [[nodiscard]] Tree const& as_tree() const override {
-        return *this;
+    void close_tree(std::string_view const key, usize const marker) {
+        auto const [first, count] = flush(marker);
+        m_pending.push_back(Node{ EntryKind::Tree, string(key), first, count });
     }
 
-    [[nodiscard]] char const* type_name() const override {
-        return "Tree";
+    [[nodiscard]] Document finish() && {
+        auto const [first, count] = flush(0);
+        m_storage->nodes.front().first = first;
+        m_storage->nodes.front().count = count;
+        for (auto i = usize{ 0 }; i < m_storage->nodes.size(); ++i) {
+            auto const& node = m_storage->nodes.at(i);
+            if (node.kind == EntryKind::Tree and node.count >= indexed_tree_threshold) {
+                m_storage->indices.emplace(narrow(i), build_index(node));
+            }
+        }
+        return Document{ std::move(m_storage) };
     }
 
-    [[nodiscard]] Dict const& entries() const {
-        return m_entries;
+private:
+    [[nodiscard]] u32 string(std::string_view const value) {
+        auto const [iterator, inserted] = m_string_indices.try_emplace(value, 0);
+        if (inserted) {
+            iterator->second = narrow(m_storage->strings.size());
+            m_storage->strings.emplace_back(std::string{ value });
+        }
+        return iterator->second;
     }
 
-    [[nodiscard]] auto cbegin() const {
-        return m_entries.cbegin();
+    // Counting sort of the children by key, which keeps children with the same key in document order.
+    [[nodiscard]] TreeIndex build_index(Node const& tree) const {
+        auto ranges = std::unordered_map<u32, TreeIndex::Range>{};
+        for (auto i = tree.first; i < tree.first + tree.count; ++i) {
+            ++ranges[m_storage->nodes.at(i).key].count;
+        }
+        auto index = TreeIndex{};
+        auto offset = u32{ 0 };
+        for (auto& [key, range] : ranges) {
+            range.first = offset;
+            offset += range.count;
+            range.count = 0;
+        }
+        index.children.resize(tree.count);
+        for (auto i = tree.first; i < tree.first + tree.count; ++i) {
+            auto& range = ranges.at(m_storage->nodes.at(i).key);
+            index.children.at(range.first + range.count) = i;
+            ++range.count;
+        }
+        index.keys.reserve(ranges.size());
+        for (auto const& [key, range] : ranges) {
+            index.keys.emplace(m_storage->strings.at(key).view(), range);
+        }
+        return index;
     }
 
-    [[nodiscard]] auto cend() const {
-        return m_entries.cend();
+    [[nodiscard]] std::pair<u32, u32> flush(usize const marker) {
+        auto const first = narrow(m_storage->nodes.size());
+        auto const count = narrow(m_pending.size() - marker);
+        m_storage->nodes.insert(
+            m_storage->nodes.end(),
+            m_pending.begin() + static_cast<std::ptrdiff_t>(marker),
+            m_pending.end()
+        );
+        m_pending.resize(marker);
+        return { first, count };
+    }
+
+    [[nodiscard]] static u32 narrow(usize const value) {
+        if (value > std::numeric_limits<u32>::max()) {
+            throw std::runtime_error{ "Document too large." };
+        }
+        return static_cast<u32>(value);
     }
 };
 
-class String final : public Entry {
-public:
-    using ValueType = c2k::Utf8String;
+struct String final {
+    using ValueType = c2k::Utf8StringView;
+    static constexpr auto kind = EntryKind::String;
+};
+
+struct Reference final {
+    using ValueType = Reference;
+    static constexpr auto kind = EntryKind::Reference;
+};
+
+template<typename T>
+concept EntryType = requires {
+    typename T::ValueType;
+    { T::kind } -> std::convertible_to<EntryKind>;
+};
 
+class Entry final {
 private:
-    c2k::Utf8String m_value;
+    DocumentStorage const* m_storage;
+    u32 m_index;
 
 public:
-    explicit String(c2k::Utf8String value)
-        : m_value{ std::move(value) } {}
+    Entry(DocumentStorage const& storage, u32 const index)
+        : m_storage{ &storage }, m_index{ index } {}
 
-    [[nodiscard]] bool is_string() const override {
-        return true;
+    [[nodiscard]] EntryKind kind() const {
+        return node().kind;
     }
 
-    [[nodiscard]] c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const override;
+    [[nodiscard]] bool is_tree() const {
+        return kind() == EntryKind::Tree;
+    }
+
+    [[nodiscard]] bool is_string() const {
+        return kind() == EntryKind::String;
+    }
 
-    [[nodiscard]] String const& as_string() const override {
-        return *this;
+    [[nodiscard]] bool is_identifier_list() const {
+        return kind() == EntryKind::IdentifierList;
     }
 
-    [[nodiscard]] char const* type_name() const override {
-        return "String";
+    [[nodiscard]] bool is_reference() const {
+        return kind() == EntryKind::Reference;
     }
 
-    [[nodiscard]] c2k::Utf8String const& value() const {
-        return m_value;
+    [[nodiscard]] c2k::Utf8String const& key() const {
+        return m_storage->strings.at(node().key);
+    }
+
+    [[nodiscard]] Tree as_tree() const;
+    [[nodiscard]] c2k::Utf8String const& as_string() const;
+    [[nodiscard]] IdentifierList as_identifier_list() const;
+
+    template<EntryType T>
+    [[nodiscard]] typename T::ValueType as() const;
+
+    [[nodiscard]] char const* type_name() const;
+    [[nodiscard]] c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const;
+
+private:
+    [[nodiscard]] Node const& node() const {
+        return m_storage->nodes.at(m_index);
     }
 };
 
-class IdentifierList final : public Entry {
+class IdentifierList final {
 public:
-    using ValueType = std::vector<c2k::Utf8String>;
+    using ValueType = IdentifierList;
+    static constexpr auto kind = EntryKind::IdentifierList;
+
+    class ConstIterator final {
+    private:
+        DocumentStorage const* m_storage = nullptr;
+        u32 m_index = 0;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = c2k::Utf8String;
+        using difference_type = std::ptrdiff_t;
+        using pointer = c2k::Utf8String const*;
+        using reference = c2k::Utf8String const&;
+
+        ConstIterator() = default;
+
+        ConstIterator(DocumentStorage const& storage, u32 const index)
+            : m_storage{ &storage }, m_index{ index } {}
+
+        [[nodiscard]] reference operator*() const {
+            return m_storage->strings.at(m_storage->identifiers.at(m_index));
+        }
+
+        ConstIterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            auto const result = *this;
+            ++m_index;
+            return result;
+        }
+
+        [[nodiscard]] bool operator==(ConstIterator const& other) const {
+            return m_index == other.m_index;
+        }
+    };
 
 private:
-    std::vector<c2k::Utf8String> m_values;
+    DocumentStorage const* m_storage;
+    u32 m_first;
+    u32 m_count;
 
 public:
-    explicit IdentifierList(std::vector<c2k::Utf8String> values)
-        : m_values{ std::move(values) } {}
+    IdentifierList(DocumentStorage const& storage, u32 const first, u32 const count)
+        : m_storage{ &storage }, m_first{ first }, m_count{ count } {}
 
-    [[nodiscard]] bool is_identifier_list() const override {
-        return true;
+    [[nodiscard]] usize size() const {
+        return m_count;
     }
 
-    [[nodiscard]] c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const override;
+    [[nodiscard]] c2k::Utf8String const& front() const {
+        return *begin();
+    }
 
-    [[nodiscard]] IdentifierList const& as_identifier_list() const override {
-        return *this;
+    [[nodiscard]] ConstIterator begin() const {
+        return ConstIterator{ *m_storage, m_first };
     }
 
-    [[nodiscard]] char const* type_name() const override {
-        return "IdentifierList";
+    [[nodiscard]] ConstIterator end() const {
+        return ConstIterator{ *m_storage, m_first + m_count };
     }
 
-    [[nodiscard]] std::vector<c2k::Utf8String> const& values() const {
-        return m_values;
+    // Copies the identifiers out of the document.
+    [[nodiscard]] std::vector<c2k::Utf8String> values() const {
+        return std::vector<c2k::Utf8String>(begin(), end());
     }
 };
 
-class Reference final : public Entry {
+class Tree final {
 public:
-    using ValueType = Reference;
+    using ValueType = Tree;
+    static constexpr auto kind = EntryKind::Tree;
 
-    [[nodiscard]] bool is_reference() const override {
-        return true;
+    struct KeyValuePair final {
+        c2k::Utf8String const& key;
+        Entry value;
+    };
+
+    class ConstIterator final {
+    private:
+        DocumentStorage const* m_storage = nullptr;
+        u32 m_index = 0;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = KeyValuePair;
+        using difference_type = std::ptrdiff_t;
+
+        ConstIterator() = default;
+
+        ConstIterator(DocumentStorage const& storage, u32 const index)
+            : m_storage{ &storage }, m_index{ index } {}
+
+        [[nodiscard]] KeyValuePair operator*() const {
+            auto const entry = Entry{ *m_storage, m_index };
+            return KeyValuePair{ entry.key(), entry };
+        }
+
+        ConstIterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            auto const result = *this;
+            ++m_index;
+            return result;
+        }
+
+        [[nodiscard]] bool operator==(ConstIterator const& other) const {
+            return m_index == other.m_index;
+        }
+    };
+
+private:
+    DocumentStorage const* m_storage;
+    u32 m_index;
+
+public:
+    Tree(DocumentStorage const& storage, u32 const index)
+        : m_storage{ &storage }, m_index{ index } {}
+
+    template<EntryType T>
+    [[nodiscard]] auto try_fetch(c2k::Utf8StringView key) const -> tl::optional<typename T::ValueType>;
+
+    template<EntryType T>
+    [[nodiscard]] auto fetch(c2k::Utf8StringView const key) const -> typename T::ValueType {
+        auto result = try_fetch<T>(key);
+        if (not result.has_value()) {
+            throw std::runtime_error{ "Required key \"" + std::string{ key.view() } + "\" not found or type mismatch." };
+        }
+        return std::move(result).value();
+    }
+
+    template<EntryType T>
+    [[nodiscard]] auto fetch_all(c2k::Utf8StringView key) const -> std::vector<typename T::ValueType>;
+
+    [[nodiscard]] usize size() const {
+        return node().count;
+    }
+
+    [[nodiscard]] ConstIterator begin() const {
+        return ConstIterator{ *m_storage, node().first };
     }
 
-    [[nodiscard]] c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const override;
+    [[nodiscard]] ConstIterator end() const {
+        return ConstIterator{ *m_storage, node().first + node().count };
+    }
+
+    [[nodiscard]] c2k::Utf8String pretty_print(usize base_indentation, usize indentation_step) const;
 
-    [[nodiscard]] Reference const& as_reference() const override {
-        return *this;
+private:
+    [[nodiscard]] Node const& node() const {
+        return m_storage->nodes.at(m_index);
     }
 
-    [[nodiscard]] char const* type_name() const override {
-        return "Reference";
+    [[nodiscard]] TreeIndex const* key_index() const {
+        if (node().count < indexed_tree_threshold) {
+            return nullptr;
+        }
+        return &m_storage->indices.at(m_index);
     }
 };
 
-template<std::derived_from<Entry> T>
-auto Tree::try_fetch(c2k::Utf8StringView const key) const -> tl::optional<typename T::ValueType const&> {
-    auto const iterator =
-        std::find_if(m_entries.cbegin(), m_entries.cend(), [&](auto const& pair) { return pair.first == key; });
-    if (iterator == m_entries.cend()) {
-        // Not found.
-        return tl::nullopt;
+[[nodiscard]] inline Tree Document::root() const {
+    return Tree{ *m_storage, 0 };
+}
+
+[[nodiscard]] inline Tree Entry::as_tree() const {
+    if (not is_tree()) {
+        throw std::bad_cast{};
+    }
+    return Tree{ *m_storage, m_index };
+}
+
+[[nodiscard]] inline c2k::Utf8String const& Entry::as_string() const {
+    if (not is_string()) {
+        throw std::bad_cast{};
+    }
+    return m_storage->strings.at(node().first);
+}
+
+[[nodiscard]] inline IdentifierList Entry::as_identifier_list() const {
+    if (not is_identifier_list()) {
+        throw std::bad_cast{};
     }
+    return IdentifierList{ *m_storage, node().first, node().count };
+}
+
+template<EntryType T>
+[[nodiscard]] typename T::ValueType Entry::as() const {
     if constexpr (std::same_as<T, String>) {
-        if (not iterator->second->is_string()) {
-            return tl::nullopt;
-        }
-        return iterator->second->as_string().value();
+        return as_string();
     } else if constexpr (std::same_as<T, Tree>) {
-        if (not iterator->second->is_tree()) {
+        return as_tree();
+    } else if constexpr (std::same_as<T, IdentifierList>) {
+        return as_identifier_list();
+    } else {
+        static_assert(std::same_as<T, Reference>);
+        if (not is_reference()) {
+            throw std::bad_cast{};
+        }
+        return Reference{};
+    }
+}
+
+template<EntryType T>
+auto Tree::try_fetch(c2k::Utf8StringView const key) const -> tl::optional<typename T::ValueType> {
+    if (auto const index = key_index()) {
+        auto const children = index->find(key.view());
+        if (children.empty()) {
             return tl::nullopt;
         }
-        return iterator->second->as_tree().entries();
-    } else if constexpr (std::same_as<T, IdentifierList>) {
-        if (not iterator->second->is_identifier_list()) {
+        auto const value = Entry{ *m_storage, children.front() };
+        if (value.kind() != T::kind) {
             return tl::nullopt;
         }
-        return iterator->second->as_identifier_list().values();
-    } else if constexpr (std::same_as<T, Reference>) {
-        if (not iterator->second->is_reference()) {
+        return value.template as<T>();
+    }
+    for (auto const& [current_key, value] : *this) {
+        if (current_key != key) {
+            continue;
+        }
+        if (value.kind() != T::kind) {
             return tl::nullopt;
         }
-        return iterator->second->as_reference();
-    } else {
-        throw;
+        return value.template as<T>();
     }
+    // Not found.
+    return tl::nullopt;
 }
 
-template<std::derived_from<Entry> T>
-auto Tree::fetch_all(c2k::Utf8StringView const key) const -> std::vector<typename T::ValueType const*> {
-    auto results = std::vector<typename T::ValueType const*>{};
-    for (auto const& [current_key, value] : m_entries) {
-        if (key != current_key) {
-            continue;
-        }
-        if constexpr (std::same_as<T, String>) {
-            if (not value->is_string()) {
-                continue;
-            }
-            return &value->as_string().value();
-        } else if constexpr (std::same_as<T, Tree>) {
-            if (not value->is_tree()) {
-                continue;
-            }
-            return &value->as_tree().entries();
-        } else if constexpr (std::same_as<T, IdentifierList>) {
-            if (not value->is_identifier_list()) {
-                continue;
-            }
-            return &value->as_identifier_list().values();
-        } else if constexpr (std::same_as<T, Reference>) {
-            if (not value->is_reference()) {
-                continue;
+template<EntryType T>
+auto Tree::fetch_all(c2k::Utf8StringView const key) const -> std::vector<typename T::ValueType> {
+    auto results = std::vector<typename T::ValueType>{};
+    if (auto const index = key_index()) {
+        for (auto const child : index->find(key.view())) {
+            auto const value = Entry{ *m_storage, child };
+            if (value.kind() == T::kind) {
+                results.push_back(value.template as<T>());
             }
-            return &value->as_reference();
-        } else {
-            throw;
         }
+        return results;
+    }
+    for (auto const& [current_key, value] : *this) {
+        if (current_key != key or value.kind() != T::kind) {
+            continue;
+        }
+        results.push_back(value.template as<T>());
     }
     return results;
 }
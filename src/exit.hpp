@@ -3,20 +3,22 @@
 #include <lib2k/utf8/string.hpp>
 #include <vector>
 #include "item.hpp"
+#include "styled_text.hpp"
+#include "symbol.hpp"
 
 struct Exit final {
-    c2k::Utf8String target_room;
-    c2k::Utf8String description;
+    Symbol target_room;
+    StyledText description;
     std::vector<ItemBlueprint const*> required_items;
-    std::optional<c2k::Utf8String> on_locked;
+    std::optional<StyledText> on_locked;
 
     explicit Exit(
-        c2k::Utf8String target_room,
-        c2k::Utf8String description,
+        Symbol const target_room,
+        StyledText description,
         std::vector<ItemBlueprint const*> required_items,
-        std::optional<c2k::Utf8String> on_locked
+        std::optional<StyledText> on_locked
     )
-        : target_room{ std::move(target_room) },
+        : target_room{ target_room },
           description{ std::move(description) },
           required_items{ std::move(required_items) },
           on_locked{ std::move(on_locked) } {
@@ -15,50 +15,50 @@ using namespace c2k::Utf8Literals;
     return indentation;
 }
 
-[[nodiscard]] Tree const& Entry::as_tree() const {
-    throw std::bad_cast{};
-}
-
-[[nodiscard]] String const& Entry::as_string() const {
-    throw std::bad_cast{};
-}
-
-[[nodiscard]] IdentifierList const& Entry::as_identifier_list() const {
-    throw std::bad_cast{};
+[[nodiscard]] char const* Entry::type_name() const {
+    switch (kind()) {
+        case EntryKind::Tree:
+            return "Tree";
+        case EntryKind::String:
+            return "String";
+        case EntryKind::IdentifierList:
+            return "IdentifierList";
+        case EntryKind::Reference:
+            return "Reference";
+    }
+    return "Unknown";
 }
 
-[[nodiscard]] Reference const& Entry::as_reference() const {
-    throw std::bad_cast{};
+[[nodiscard]] c2k::Utf8String Entry::pretty_print(usize const base_indentation, usize const indentation_step) const {
+    switch (kind()) {
+        case EntryKind::Tree:
+            return as_tree().pretty_print(base_indentation, indentation_step);
+        case EntryKind::String:
+            return indent('"'_utf8 + as_string() + '"'_utf8, base_indentation);
+        case EntryKind::IdentifierList:
+            return indent(", "_utf8.join(as_identifier_list().values()), base_indentation);
+        case EntryKind::Reference:
+            break;
+    }
+    return "";
 }
 
 [[nodiscard]] c2k::Utf8String Tree::pretty_print(usize const base_indentation, usize const indentation_step) const {
     auto result = c2k::Utf8String{};
-    for (auto const& [key, value] : m_entries) {
+    for (auto const& [key, value] : *this) {
         result += indent(key, base_indentation);
-        if (value->is_reference()) {
+        if (value.is_reference()) {
             result += '\n';
             continue;
         }
         result += ": ";
-        if (value->is_tree()) {
+        if (value.is_tree()) {
             result += '\n';
-            result += value->pretty_print(base_indentation + indentation_step, indentation_step);
+            result += value.pretty_print(base_indentation + indentation_step, indentation_step);
         } else {
-            result += value->pretty_print(0, 0);
+            result += value.pretty_print(0, 0);
             result += '\n';
         }
     }
     return result;
 }
-
-[[nodiscard]] c2k::Utf8String String::pretty_print(usize const base_indentation, usize) const {
-    return indent('"'_utf8 + m_value + '"'_utf8, base_indentation);
-}
-
-[[nodiscard]] c2k::Utf8String IdentifierList::pretty_print(usize const base_indentation, usize) const {
-    return indent(", "_utf8.join(m_values), base_indentation);
-}
-
-[[nodiscard]] c2k::Utf8String Reference::pretty_print(usize base_indentation, usize indentation_step) const {
-    return "";
-}
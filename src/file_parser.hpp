@@ -16,110 +16,110 @@
 #include "token.hpp"
 #include "utils.hpp"
 
+// Pulls the tokens from the lexer one at a time, so only the current token is kept in memory.
 class FileParser final {
 private:
-    std::vector<Token> m_tokens;
-    usize m_index = 0;
+    std::string_view m_source;
+    Lexer m_lexer;
+    Token m_current;
 
 public:
-    explicit FileParser(std::vector<Token> tokens)
-        : m_tokens{ std::move(tokens) } {}
-
-    [[nodiscard]] Tree parse() {
-        return tree();
+    // The source has to outlive the parser, since the tokens only refer to it.
+    explicit FileParser(c2k::Utf8StringView const source)
+        : m_source{ source.view() }, m_lexer{ source }, m_current{ m_lexer.next() } {}
+
+    [[nodiscard]] Document parse() {
+        auto builder = DocumentBuilder{};
+        tree(builder);
+        // Lex the rest of the input (if any) to report errors in it.
+        while (not is_at_end()) {
+            advance();
+        }
+        return std::move(builder).finish();
     }
 
 private:
-    [[nodiscard]] std::vector<c2k::Utf8String> identifier_list() {
-        auto identifiers = std::vector{ expect<token::Identifier>("Expected identifier").lexeme };
-        while (match<token::Comma>()) {
-            identifiers.push_back(expect<token::Identifier>("Expected identifier").lexeme);
+    [[nodiscard]] std::vector<std::string_view> identifier_list() {
+        auto identifiers = std::vector{ lexeme(expect(TokenType::Identifier, "Expected identifier")) };
+        while (match(TokenType::Comma)) {
+            identifiers.push_back(lexeme(expect(TokenType::Identifier, "Expected identifier")));
         }
         // Allow trailing comma.
-        std::ignore = match<token::Comma>();
-        expect<token::Linebreak>("Expected linebreak");
+        std::ignore = match(TokenType::Comma);
+        expect(TokenType::Linebreak, "Expected linebreak");
         return identifiers;
     }
 
-    [[nodiscard]] Tree tree() {
-        auto dict = Tree::Dict{};
-
+    void tree(DocumentBuilder& builder) {
         // Ignore leading linebreaks (if the file is empty, this will ignore the
         // complete file, which is okay).
-        while (match<token::Linebreak>()) {}
+        while (match(TokenType::Linebreak)) {}
 
-        while (not is_at_end() and not current_is<token::Dedent>()) {
-            auto const& key = expect<token::Identifier>("Expected identifier");
-            if (match<token::Linebreak>()) {
-                dict.emplace_back(key.lexeme, std::make_unique<Reference>());
+        while (not is_at_end() and not current_is(TokenType::Dedent)) {
+            auto const key = lexeme(expect(TokenType::Identifier, "Expected identifier"));
+            if (match(TokenType::Linebreak)) {
+                builder.add_reference(key);
                 continue;
             }
-            expect<token::Colon>("Expected ':'");
-            if (auto const string = match<token::String>()) {
-                dict.emplace_back(key.lexeme, std::make_unique<String>(string.value().lexeme));
-                expect<token::Linebreak>("Expected linebreak after string");
+            expect(TokenType::Colon, "Expected ':'");
+            if (auto const string = match(TokenType::String)) {
+                builder.add_string(key, lexeme(string.value()));
+                expect(TokenType::Linebreak, "Expected linebreak after string");
                 continue;
             }
 
-            if (current_is<token::Identifier>()) {
-                dict.emplace_back(key.lexeme, std::make_unique<IdentifierList>(identifier_list()));
+            if (current_is(TokenType::Identifier)) {
+                builder.add_identifier_list(key, identifier_list());
                 continue;
             }
-            expect<token::Linebreak>("Expected string, identifier list, or linebreak");
-            expect<token::Indent>("Subtree must be indented");
-            dict.emplace_back(key.lexeme, std::make_unique<Tree>(tree()));
-            expect<token::Dedent>("Subtree must end with dedent");
+            expect(TokenType::Linebreak, "Expected string, identifier list, or linebreak");
+            expect(TokenType::Indent, "Subtree must be indented");
+            auto const marker = builder.open_tree();
+            tree(builder);
+            builder.close_tree(key, marker);
+            expect(TokenType::Dedent, "Subtree must end with dedent");
         }
+    }
 
-        return Tree{ std::move(dict) };
+    // Lexemes are only copied out of the source when the document builder interns them.
+    [[nodiscard]] std::string_view lexeme(Token const& token) const {
+        return token.lexeme(m_source);
     }
 
-    template<typename T>
-    T const& expect(char const* const error_message) {
-        if (auto const result = match<T>()) {
+    Token expect(TokenType const type, char const* const error_message) {
+        if (auto const result = match(type)) {
             return result.value();
         }
-        auto stream = std::ostringstream{};
-        stream << error_message << " (got " << current() << " instead)";
-        throw std::runtime_error{ std::move(stream).str() };
+        throw std::runtime_error{ std::string{ error_message } + " (got " + describe(current(), m_source)
+                                  + " instead)" };
     }
 
-    template<typename T>
-    [[nodiscard]] tl::optional<T const&> match() {
-        if (not current_is<T>()) {
+    [[nodiscard]] tl::optional<Token> match(TokenType const type) {
+        if (not current_is(type)) {
             return tl::nullopt;
         }
-        auto const& result = std::get<T>(current());
+        auto const result = current();
         advance();
         return result;
     }
 
-    template<typename T>
-    [[nodiscard]] bool current_is() const {
-        return is<T>(current());
+    [[nodiscard]] bool current_is(TokenType const type) const {
+        return current().type == type;
     }
 
     [[nodiscard]] bool is_at_end() const {
-        return m_index >= m_tokens.size() or is<token::EndOfInput>(m_tokens.at(m_index));
+        return m_current.type == TokenType::EndOfInput;
     }
 
     [[nodiscard]] Token const& current() const {
-        if (is_at_end()) {
-            return m_tokens.back();
-        }
-        return m_tokens.at(m_index);
+        return m_current;
     }
 
     void advance() {
         if (is_at_end()) {
             return;
         }
-        ++m_index;
-    }
-
-    template<typename T>
-    [[nodiscard]] static bool is(Token const& token) {
-        return std::holds_alternative<T>(token);
+        m_current = m_lexer.next();
     }
 };
 
@@ -127,23 +127,29 @@ class File final {
 private:
     std::filesystem::path m_filepath;
     std::string m_filename;
-    Tree m_contents;
+    Document m_contents;
 
 public:
     explicit File(std::filesystem::path const& filepath)
         : m_filepath{ canonical(filepath) },
           m_filename{ m_filepath.filename().string() },
-          m_contents{ FileParser{ Lexer{ read_file(m_filepath) }.tokenize() }.parse() } {}
+          m_contents{ parse(m_filepath) } {}
 
-    [[nodiscard]] Tree const& tree() const& {
+    [[nodiscard]] Document const& document() const& {
         return m_contents;
     }
 
-    [[nodiscard]] Tree tree() && {
+    [[nodiscard]] Document document() && {
         return std::move(m_contents);
     }
 
     friend std::ostream& operator<<(std::ostream& ostream, File const& file) {
-        return ostream << file.m_filename << '\n' << file.m_contents.pretty_print(0, 4).view();
+        return ostream << file.m_filename << '\n' << file.m_contents.root().pretty_print(0, 4).view();
+    }
+
+private:
+    [[nodiscard]] static Document parse(std::filesystem::path const& path) {
+        auto const source = read_file(path);
+        return FileParser{ source }.parse();
     }
 };
@@ -0,0 +1,29 @@
+#include "flag_set.hpp"
+#include <mutex>
+#include <unordered_map>
+
+struct FlagIndices final {
+    std::mutex mutex;
+    std::unordered_map<Symbol, u32> indices;
+};
+
+[[nodiscard]] static u32 flag_index(Symbol const flag) {
+    static auto flag_indices = FlagIndices{};
+    auto const lock = std::scoped_lock{ flag_indices.mutex };
+    auto const [iterator, inserted] =
+        flag_indices.indices.try_emplace(flag, static_cast<u32>(flag_indices.indices.size()));
+    return iterator->second;
+}
+
+[[nodiscard]] FlagSet FlagSet::of(std::vector<Symbol> const& flags) {
+    auto result = FlagSet{};
+    for (auto const flag : flags) {
+        auto const index = flag_index(flag);
+        auto const word_index = index / 64;
+        if (result.m_words.size() <= word_index) {
+            result.m_words.resize(word_index + 1, 0);
+        }
+        result.m_words[word_index] |= u64{ 1 } << (index % 64);
+    }
+    return result;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <lib2k/types.hpp>
+#include <vector>
+#include "symbol.hpp"
+
+// A set of flags (the identifiers used by `define`, `undefine`, `if` and `if_not`), stored as a
+// bitset. Every flag is assigned a dense bit index the first time it's used while loading the
+// content. Actions precompute the set of flags they refer to, so that checking or changing any
+// number of flags only takes a few word-wise bit operations.
+class FlagSet final {
+private:
+    std::vector<u64> m_words;
+
+public:
+    FlagSet() = default;
+
+    [[nodiscard]] static FlagSet of(std::vector<Symbol> const& flags);
+
+    void insert(FlagSet const& flags) {
+        if (m_words.size() < flags.m_words.size()) {
+            m_words.resize(flags.m_words.size(), 0);
+        }
+        for (auto i = usize{ 0 }; i < flags.m_words.size(); ++i) {
+            m_words[i] |= flags.m_words[i];
+        }
+    }
+
+    void erase(FlagSet const& flags) {
+        for (auto i = usize{ 0 }; i < std::min(m_words.size(), flags.m_words.size()); ++i) {
+            m_words[i] &= ~flags.m_words[i];
+        }
+    }
+
+    [[nodiscard]] bool contains_all(FlagSet const& flags) const {
+        for (auto i = usize{ 0 }; i < flags.m_words.size(); ++i) {
+            if ((word(i) & flags.m_words[i]) != flags.m_words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool contains_none(FlagSet const& flags) const {
+        for (auto i = usize{ 0 }; i < flags.m_words.size(); ++i) {
+            if ((word(i) & flags.m_words[i]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Sets that only differ in trailing empty words are equal.
+    [[nodiscard]] bool operator==(FlagSet const& other) const {
+        for (auto i = usize{ 0 }; i < std::max(m_words.size(), other.m_words.size()); ++i) {
+            if (word(i) != other.word(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] usize hash() const {
+        auto result = usize{ 0 };
+        for (auto i = used_words(); i > 0; --i) {
+            result = result * 31 + std::hash<u64>{}(m_words[i - 1]);
+        }
+        return result;
+    }
+
+private:
+    [[nodiscard]] u64 word(usize const index) const {
+        return index < m_words.size() ? m_words[index] : 0;
+    }
+
+    [[nodiscard]] usize used_words() const {
+        auto count = m_words.size();
+        while (count > 0 and m_words[count - 1] == 0) {
+            --count;
+        }
+        return count;
+    }
+};
+
+template<>
+struct std::hash<FlagSet> {
+    [[nodiscard]] usize operator()(FlagSet const& flags) const noexcept {
+        return flags.hash();
+    }
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "terminal.hpp"
+
+// Keeps everything that is written in memory, e.g. to compare the output of a replay with a previous one.
+class TranscriptTerminal final : public Terminal {
+private:
+    std::string m_transcript;
+
+public:
+    using Terminal::Terminal;
+
+    [[nodiscard]] std::string_view transcript() const {
+        return m_transcript;
+    }
+
+private:
+    void write(std::string_view const bytes) override {
+        m_transcript += bytes;
+    }
+};
+
+// Discards all output, so that the game can run at full speed without a screen.
+class NullTerminal final : public Terminal {
+public:
+    using Terminal::Terminal;
+
+private:
+    void write(std::string_view) override {}
+};
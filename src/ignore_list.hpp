@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include "utils.hpp"
+#include "word_list.hpp"
+
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+#include "builtin_words.hpp"
+#endif
+
+// The words that are dropped from the player's commands.
+class IgnoreList final {
+private:
+    std::unordered_set<std::string, StringHash, std::equal_to<>> m_words;
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+    bool m_builtin = false;  // Whether the list matches the built-in table, which is used instead.
+#endif
+
+public:
+    explicit IgnoreList(c2k::Utf8String const& contents) {
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        m_builtin = builtin_words::matches_ignore_list(contents);
+        if (m_builtin) {
+            return;
+        }
+#endif
+        for (auto const& word : read_word_list(contents)) {
+            m_words.emplace(word.view());
+        }
+    }
+
+    [[nodiscard]] bool contains(c2k::Utf8StringView const word) const {
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        if (m_builtin) {
+            return builtin_words::is_ignored(word.view());
+        }
+#endif
+        return m_words.contains(word.view());
+    }
+};
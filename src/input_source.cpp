@@ -0,0 +1,26 @@
+#include "input_source.hpp"
+#include <iostream>
+#include <string>
+
+[[nodiscard]] c2k::Utf8String StdinInput::read_line() {
+    auto input = std::string{};
+    if (not std::getline(std::cin, input)) {
+        throw EndOfInput{ "Failed to read line." };
+    }
+    return input;
+}
+
+ScriptInput::ScriptInput(c2k::Utf8StringView const script) {
+    m_lines = c2k::Utf8String{ script }.split("\n");
+    // A script that ends with a line break doesn't contain an additional empty line.
+    if (not m_lines.empty() and m_lines.back().is_empty()) {
+        m_lines.pop_back();
+    }
+}
+
+[[nodiscard]] c2k::Utf8String ScriptInput::read_line() {
+    if (m_next_line >= m_lines.size()) {
+        throw EndOfInput{ "End of script reached." };
+    }
+    return m_lines.at(m_next_line++);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <lib2k/types.hpp>
+#include <lib2k/utf8/string.hpp>
+#include <lib2k/utf8/string_view.hpp>
+#include <stdexcept>
+#include <vector>
+
+// Thrown when an input source has no lines left.
+class EndOfInput final : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Provides the lines the player enters.
+class InputSource {
+public:
+    InputSource() = default;
+    InputSource(InputSource const& other) = default;
+    InputSource(InputSource&& other) noexcept = default;
+    InputSource& operator=(InputSource const& other) = default;
+    InputSource& operator=(InputSource&& other) noexcept = default;
+    virtual ~InputSource() = default;
+
+    // Throws `EndOfInput` if there are no lines left.
+    [[nodiscard]] virtual c2k::Utf8String read_line() = 0;
+};
+
+class StdinInput final : public InputSource {
+public:
+    [[nodiscard]] c2k::Utf8String read_line() override;
+};
+
+// Feeds the lines of a script, e.g. to replay a recorded game session.
+class ScriptInput final : public InputSource {
+private:
+    std::vector<c2k::Utf8String> m_lines;
+    usize m_next_line = 0;
+
+public:
+    explicit ScriptInput(c2k::Utf8StringView script);
+
+    [[nodiscard]] c2k::Utf8String read_line() override;
+};
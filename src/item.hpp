@@ -28,22 +28,12 @@ public:
     }
 
     [[nodiscard]] bool try_execute_action(
-        c2k::Utf8StringView const category,
+        Symbol const category,
         std::vector<Item*> const& targets,
         ActionContext const& context
     ) {
-        for (auto const& [action_category, actions] : m_blueprint->actions()) {
-            if (action_category != category) {
-                continue;
-            }
-            auto actions_completed = true;
-            for (auto const& action : actions) {
-                if (not action->try_execute(*this, targets, context)) {
-                    actions_completed = false;
-                    break;
-                }
-            }
-            if (actions_completed) {
+        for (auto const& actions : m_blueprint->actions(category)) {
+            if (actions.execute(*this, targets, context)) {
                 return true;
             }
         }
@@ -7,6 +7,14 @@
     return std::find(m_classes.cbegin(), m_classes.cend(), name) != m_classes.cend();
 }
 
+[[nodiscard]] std::span<ActionList const> ItemBlueprint::actions(Symbol const category) const {
+    auto const find_iterator = m_actions.find(category);
+    if (find_iterator == m_actions.cend()) {
+        return {};
+    }
+    return find_iterator->second;
+}
+
 [[nodiscard]] std::unique_ptr<Item> ItemBlueprint::instantiate() const {
     return std::make_unique<Item>(*this, Inventory{});
 }
@@ -1,29 +1,35 @@
 #pragma once
 
+#include <span>
 #include <unordered_map>
 #include "action.hpp"
+#include "styled_text.hpp"
+#include "symbol.hpp"
 
 class ItemBlueprint final {
 public:
-    using Actions = std::vector<std::pair<c2k::Utf8String, std::vector<std::unique_ptr<Action>>>>;
+    // Maps each verb category to its alternative action lists, in the order they are defined.
+    using Actions = std::unordered_map<Symbol, std::vector<ActionList>>;
 
 private:
-    c2k::Utf8String m_reference;
+    Symbol m_reference;
     c2k::Utf8String m_name;
-    c2k::Utf8String m_description;
+    c2k::Utf8String m_folded_name;
+    StyledText m_description;
     std::vector<c2k::Utf8String> m_classes;
     Actions m_actions;
 
 public:
     explicit ItemBlueprint(
-        c2k::Utf8String reference,
+        Symbol const reference,
         c2k::Utf8String name,
-        c2k::Utf8String description,
+        StyledText description,
         std::vector<c2k::Utf8String> classes,
         Actions actions
     )
-        : m_reference{ std::move(reference) },
+        : m_reference{ reference },
           m_name{ std::move(name) },
+          m_folded_name{ m_name.to_lowercase() },
           m_description{ std::move(description) },
           m_classes{ std::move(classes) },
           m_actions{ std::move(actions) } {}
@@ -38,7 +44,7 @@ public:
 
     [[nodiscard]] bool has_class(c2k::Utf8StringView name) const;
 
-    [[nodiscard]] c2k::Utf8String const& reference() const {
+    [[nodiscard]] Symbol reference() const {
         return m_reference;
     }
 
@@ -46,7 +52,12 @@ public:
         return m_name;
     }
 
-    [[nodiscard]] c2k::Utf8String const& description() const {
+    // The name in lowercase, for comparing it to the words of commands.
+    [[nodiscard]] c2k::Utf8String const& folded_name() const {
+        return m_folded_name;
+    }
+
+    [[nodiscard]] StyledText const& description() const {
         return m_description;
     }
 
@@ -54,5 +65,7 @@ public:
         return m_actions;
     }
 
+    [[nodiscard]] std::span<ActionList const> actions(Symbol category) const;
+
     [[nodiscard]] std::unique_ptr<Item> instantiate() const;
 };
@@ -1,14 +1,14 @@
 #pragma once
 
-#include <lib2k/utf8/string.hpp>
 #include <vector>
 
 #include "choice.hpp"
+#include "styled_text.hpp"
 
 struct Label final {
-    c2k::Utf8String text;
+    StyledText text;  // Starts with the name of the speaker.
     std::vector<Choice> choices;
 
-    explicit Label(c2k::Utf8String text, std::vector<Choice> choices)
+    explicit Label(StyledText text, std::vector<Choice> choices)
         : text{ std::move(text) }, choices{ std::move(choices) } {}
 };
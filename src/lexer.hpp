@@ -3,24 +3,41 @@
 #include <lib2k/types.hpp>
 #include <lib2k/utf8/string.hpp>
 #include <lib2k/utf8/string_view.hpp>
+#include <limits>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "byte_scan.hpp"
 #include "token.hpp"
 
 #include "utils.hpp"
 
-class Lexer final {
+// The lexer works on the bytes of the UTF-8 encoded source. All characters with a special meaning
+// are ASCII, and ASCII bytes never occur within multibyte sequences.
+//
+// Tokens are produced on demand by `next()`, so the token stream never has to be held in memory as
+// a whole. INDENT and DEDENT tokens are synthesized one at a time after a linebreak, until the
+// indentation level of the new line has been reached.
+//
+// The scanner decides how the hot loops look at the bytes (see `byte_scan.hpp`). Apart from the tests,
+// which compare all of them, only the fastest one the target supports is used.
+template<typename Scanner = byte_scan::FastestScanner>
+class BasicLexer final {
 private:
-    c2k::Utf8StringView m_source;
-    c2k::Utf8StringView::ConstIterator m_iterator;
-    std::vector<Token> m_tokens;
+    std::string_view m_source;
+    usize m_position = 0;
+    std::optional<usize> m_indentation_step;
+    usize m_indentation = 0;         // Measured in multiples of the step size.
+    usize m_target_indentation = 0;  // Indentation of the current line.
 
 public:
-    explicit Lexer(c2k::Utf8StringView const source)
-        : m_source{ source }, m_iterator{ m_source.cbegin() } {}
-
-    [[nodiscard]] std::vector<Token> tokenize() {
-        m_iterator = m_source.cbegin();
-        m_tokens.clear();
+    explicit BasicLexer(c2k::Utf8StringView const source)
+        : m_source{ source.view() } {
+        if (m_source.size() > std::numeric_limits<u32>::max()) {
+            throw std::runtime_error{ "Source file too large." };
+        }
 
         if (current() == '\n') {
             throw std::runtime_error{ "First line must not be empty." };
@@ -29,76 +46,33 @@ public:
         if (is_whitespace(current())) {
             throw std::runtime_error{ "First line must not start indented." };
         }
+    }
+
+    // Returns the next token. Once the end of the input has been reached, this keeps returning
+    // END_OF_INPUT tokens.
+    [[nodiscard]] Token next() {
+        if (auto const pending = pending_indentation_token()) {
+            return pending.value();
+        }
 
-        auto indentation_step = std::optional<usize>{};
-        auto indentation = usize{ 0 };  // Measured in multiples of the step size.
         while (not is_at_end()) {
-            // std::cerr << "'" << current().as_string_view() << "'\n";
             if (current() == ',') {
-                m_tokens.push_back(token::Comma{});
+                auto const comma = token(TokenType::Comma, m_position, m_position);
                 advance();
-                continue;
+                return comma;
             }
 
             if (current() == ':') {
-                m_tokens.push_back(token::Colon{});
+                auto const colon = token(TokenType::Colon, m_position, m_position);
                 advance();
-                continue;
+                return colon;
             }
 
             if (current() == '\n') {
-                m_tokens.push_back(token::Linebreak{});
+                auto const linebreak = token(TokenType::Linebreak, m_position, m_position);
                 advance();
-
-                auto next_newline = m_source.find('\n', m_iterator);
-                while (next_newline != m_source.cend()) {
-                    auto const line = trim(m_source.substring(m_iterator, next_newline));
-                    if (line.is_empty()
-                        or (line.calculate_char_count() >= 2 and line.front() == '/' and *(line.cbegin() + 1) == '/')) {
-                        m_iterator = next_newline;
-                        advance();
-                        next_newline = m_source.find('\n', m_iterator);
-                    } else {
-                        break;
-                    }
-                }
-
-                if (is_whitespace(current()) and current() != ' ' and current() != '\n') {
-                    throw std::runtime_error{ "Lines must not start with whitespace except for regular spaces." };
-                }
-                if (not indentation_step.has_value() and current() == ' ') {
-                    auto num_leading_spaces = usize{ 0 };
-                    while (current() == ' ') {
-                        advance();
-                        ++num_leading_spaces;
-                    }
-                    indentation_step = num_leading_spaces;
-                    indentation = 1;
-                    m_tokens.emplace_back(token::Indent{});
-                } else {
-                    auto num_leading_spaces = usize{ 0 };
-                    while (current() == ' ') {
-                        advance();
-                        ++num_leading_spaces;
-                    }
-                    if (num_leading_spaces > 0 or indentation_step.has_value()) {
-                        if (num_leading_spaces % indentation_step.value() != 0) {
-                            throw std::runtime_error{ "Unexpected indentation " + std::to_string(num_leading_spaces)
-                                                      + " (must be multiple of "
-                                                      + std::to_string(indentation_step.value()) + ")." };
-                        }
-                        auto const current_indentation = num_leading_spaces / indentation_step.value();
-                        while (indentation < current_indentation) {
-                            ++indentation;
-                            m_tokens.push_back(token::Indent{});
-                        }
-                        while (indentation > current_indentation) {
-                            --indentation;
-                            m_tokens.push_back(token::Dedent{});
-                        }
-                    }
-                }
-                continue;
+                begin_line();
+                return linebreak;
             }
 
             if (current() == '/') {
@@ -106,86 +80,138 @@ public:
                 if (current() != '/') {
                     throw std::runtime_error{ "Illegal token '/' (did you mean '//' to start a comment?)" };
                 }
-                while (not is_at_end() and current() != '\n') {
-                    advance();
-                }
+                m_position = line_end();
                 continue;
             }
 
             if (current() == '"') {
                 advance();
-                auto const string_start = m_iterator;
-                auto last_quotes = std::optional<c2k::Utf8StringView::ConstIterator>{};
-                while (not is_at_end() and current() != '\n') {
-                    if (current() == '"') {
-                        last_quotes = m_iterator;
-                    }
-                    advance();
-                }
-                if (not last_quotes.has_value()) {
+                auto const string_start = m_position;
+                auto const string_end = line_end();
+                auto const line = m_source.substr(0, string_end);
+                auto const last_quotes = Scanner::find_last(line.substr(string_start), '"');
+                if (last_quotes == std::string_view::npos) {
                     throw std::runtime_error{ "Unterminated string literal." };
                 }
-                for (auto it = last_quotes.value() + 1; it != m_iterator; ++it) {
-                    if (not is_whitespace(*it)) {
-                        throw std::runtime_error{ "String literal must be the last token of line." };
-                    }
+                if (Scanner::skip_whitespace(line, string_start + last_quotes + 1) != string_end) {
+                    throw std::runtime_error{ "String literal must be the last token of line." };
                 }
-                m_tokens.push_back(token::String{
-                    c2k::Utf8String{ string_start, last_quotes.value() }
-                });
-                continue;
+                m_position = string_end;
+                return token(TokenType::String, string_start, string_start + last_quotes);
             }
 
             if (is_whitespace(current())) {
-                advance();
+                m_position = Scanner::skip_blanks(m_source, m_position);
                 continue;
             }
 
             // Identifier.
             if (not is_valid_identifier_char(current())) {
-                throw std::runtime_error{ "Expected identifier, got " + std::string{ current().as_string_view() }
-                                          + "." };
+                throw std::runtime_error{ "Expected identifier, got " + std::string{ current_utf8_char() } + "." };
             }
-            auto const identifier_start = m_iterator;
-            while (is_valid_identifier_char(current())) {
+            auto const identifier_start = m_position;
+            m_position = Scanner::skip_identifier(m_source, m_position);
+            return token(TokenType::Identifier, identifier_start, m_position);
+        }
+
+        // Close all open indentation levels before the end of the input.
+        m_target_indentation = 0;
+        if (auto const pending = pending_indentation_token()) {
+            return pending.value();
+        }
+        return token(TokenType::EndOfInput, m_position, m_position);
+    }
+
+private:
+    // Skips blank and comment lines and determines the indentation of the next line. The
+    // corresponding INDENT and DEDENT tokens are returned by the following calls to `next()`.
+    void begin_line() {
+        auto next_newline = line_end();
+        while (next_newline < m_source.size()) {
+            if (is_blank_or_comment(m_source.substr(m_position, next_newline - m_position))) {
+                m_position = next_newline;
                 advance();
+                next_newline = line_end();
+            } else {
+                break;
+            }
+        }
+
+        if (is_whitespace(current()) and current() != ' ' and current() != '\n') {
+            throw std::runtime_error{ "Lines must not start with whitespace except for regular spaces." };
+        }
+        auto const line_start = m_position;
+        m_position = Scanner::skip(m_source, m_position, ' ');
+        auto const num_leading_spaces = m_position - line_start;
+        if (not m_indentation_step.has_value()) {
+            if (num_leading_spaces > 0) {
+                m_indentation_step = num_leading_spaces;
+                m_target_indentation = 1;
             }
-            m_tokens.push_back(token::Identifier{
-                c2k::Utf8String{ identifier_start, m_iterator }
-            });
+            return;
         }
+        if (num_leading_spaces % m_indentation_step.value() != 0) {
+            throw std::runtime_error{ "Unexpected indentation " + std::to_string(num_leading_spaces)
+                                      + " (must be multiple of " + std::to_string(m_indentation_step.value())
+                                      + ")." };
+        }
+        m_target_indentation = num_leading_spaces / m_indentation_step.value();
+    }
 
-        while (indentation > 0) {
-            m_tokens.push_back(token::Dedent{});
-            --indentation;
+    [[nodiscard]] std::optional<Token> pending_indentation_token() {
+        if (m_indentation < m_target_indentation) {
+            ++m_indentation;
+            return token(TokenType::Indent, m_position, m_position);
         }
+        if (m_indentation > m_target_indentation) {
+            --m_indentation;
+            return token(TokenType::Dedent, m_position, m_position);
+        }
+        return std::nullopt;
+    }
 
-        m_tokens.emplace_back(token::EndOfInput{});
-        return std::move(m_tokens);
+    [[nodiscard]] static Token token(TokenType const type, usize const begin, usize const end) {
+        return Token{ type, static_cast<u32>(begin), static_cast<u32>(end - begin) };
     }
 
-private:
     [[nodiscard]] bool is_at_end() const {
-        return m_iterator == m_source.cend();
+        return m_position >= m_source.size();
     }
 
-    [[nodiscard]] c2k::Utf8Char current() const {
+    [[nodiscard]] char current() const {
         if (is_at_end()) {
             return '\0';
         }
-        return *m_iterator;
+        return m_source[m_position];
+    }
+
+    // Returns all bytes of the (possibly multibyte) character at the current position.
+    [[nodiscard]] std::string_view current_utf8_char() const {
+        auto const lead = static_cast<unsigned char>(current());
+        auto const length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+        return m_source.substr(m_position, static_cast<usize>(length));
+    }
+
+    // Returns the position of the next linebreak (or the end of the source).
+    [[nodiscard]] usize line_end() const {
+        return Scanner::find(m_source, m_position, '\n');
     }
 
     void advance() {
         if (is_at_end()) {
             return;
         }
-        ++m_iterator;
+        ++m_position;
     }
 
-    [[nodiscard]] static bool is_valid_identifier_char(c2k::Utf8Char const c) {
-        auto const codepoint = c.codepoint();
-        return (codepoint >= 'a' and codepoint <= 'z') or (codepoint >= 'A' and codepoint <= 'Z')
-               or (codepoint >= '0' and codepoint <= '9') or codepoint == '_';
+    [[nodiscard]] static bool is_blank_or_comment(std::string_view const line) {
+        auto const first_visible = Scanner::skip_whitespace(line, 0);
+        return first_visible == line.size() or line.substr(first_visible).starts_with("//");
+    }
+
+    [[nodiscard]] static bool is_valid_identifier_char(char const c) {
+        return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z') or (c >= '0' and c <= '9') or c == '_';
     }
 };
+
+using Lexer = BasicLexer<>;
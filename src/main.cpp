@@ -1,22 +1,44 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "ansi_terminal.hpp"
+#include "content.hpp"
+#include "content_watcher.hpp"
 #include "dialog_database.hpp"
+#include "embedded_world.hpp"
 #include "file_parser.hpp"
+#include "headless_terminal.hpp"
+#include "input_source.hpp"
 #include "item.hpp"
 #include "lexer.hpp"
 #include "parser.hpp"
 #include "synonyms_dict.hpp"
-#include "terminal.hpp"
 #include "text_database.hpp"
+#include "utils.hpp"
+#include "word_tables.hpp"
 #include "world.hpp"
+#include "world_image.hpp"
 
-[[nodiscard]] static Command get_next_command(Terminal& terminal, WordList const& ignore_list, World const& world) {
+// `before_parsing` is called after each line has been read, so that it's parsed against the current content.
+[[nodiscard]] static Command get_next_command(
+    Terminal& terminal,
+    IgnoreList const& ignore_list,
+    World const& world,
+    std::function<void()> const& before_parsing
+) {
     while (true) {
         terminal.set_text_color(TextColor::BrightWhite);
         terminal.print_raw("> ");
         terminal.reset_colors();
         auto const input = terminal.read_line();
-        auto const command = parse_command(input, world.known_objects(), ignore_list);
+        before_parsing();
+        auto const command = parse_command(input, world.objects(), ignore_list);
         if (command.has_value()) {
             return command.value();
         }
@@ -24,33 +46,207 @@
     }
 }
 
-int main() {
-    using namespace c2k::Utf8Literals;
+[[nodiscard]] static Content load_game_content(bool const use_world_image) {
+#ifdef GUESS_WHAT_EMBED_WORLD
+    if (use_world_image) {
+        return world_image::load(embedded_world_image());
+    }
+#endif
+    auto const sources = collect_source_files();
+    if (not use_world_image) {
+        return load_content(sources);
+    }
+    if (auto content = world_image::try_load(world_image::default_path, sources)) {
+        return std::move(content).value();
+    }
+    return load_content(sources);
+}
+
+// Applies all content files that have changed since the last call to the running game. If a file
+// can't be loaded, the error is reported and the previous version stays in use. Deleted files are
+// only reported.
+static void reload_changed_files(
+    ContentWatcher& watcher,
+    World& world,
+    DialogDatabase& dialog_database,
+    TextDatabase& text_database,
+    SynonymsDict& synonyms_dict,
+    IgnoreList& ignore_list
+) {
+    for (auto const& source : watcher.changed_files()) {
+        // Other content may still refer to whatever the file defined, so it stays in use.
+        if (not std::filesystem::exists(source.path)) {
+            std::cerr << "Warning: " << source.path.string() << " has been deleted, but stays in use until the game "
+                      << "is restarted.\n";
+            continue;
+        }
+        try {
+            switch (source.kind) {
+                case ContentKind::Item:
+                    world.reload_item_blueprint(load_parsed_file(source), dialog_database);
+                    break;
+                case ContentKind::Room:
+                    world.reload_room(load_parsed_file(source));
+                    break;
+                case ContentKind::Dialog:
+                    dialog_database.reload(load_parsed_file(source));
+                    break;
+                case ContentKind::Text:
+                    text_database.reload(load_raw_file(source));
+                    break;
+                case ContentKind::Synonyms:
+                    synonyms_dict.reload(load_raw_file(source));
+                    break;
+                case ContentKind::List: {
+                    auto const file = load_raw_file(source);
+                    if (file.name == "ignore") {
+                        ignore_list = IgnoreList{ file.contents };
+                    }
+                    break;
+                }
+            }
+            std::cerr << "Reloaded " << source.path.string() << '\n';
+        } catch (std::exception const& exception) {
+            std::cerr << "Error: Unable to reload " << source.path.string() << ": " << exception.what() << '\n';
+        }
+    }
+}
+
+// The pacing can be chosen with the environment variable GUESS_WHAT_PACING (see `Pacing::parse()`).
+[[nodiscard]] static std::optional<Pacing> pacing_from_environment() {
+    if (auto const value = std::getenv("GUESS_WHAT_PACING"); value != nullptr) {
+        return Pacing::parse(value);
+    }
+    return std::nullopt;
+}
 
-    auto const synonyms_dict = SynonymsDict{};
-    auto const ignore_list = read_word_list("lists/ignore.list");
-    auto const text_database = TextDatabase{};
-    auto const dialog_database = DialogDatabase{};
+// Plays the game until it has been won or the input has ended (e.g. the end of a script or of piped
+// input). In watch mode, changed content files are applied whenever a line has been entered.
+static void play(Terminal& terminal, Content const& content, std::optional<ContentWatcher>& watcher) {
+    auto synonyms_dict = SynonymsDict{ content };
+    auto ignore_list = IgnoreList{ content.list("ignore").contents };
+    auto text_database = TextDatabase{ content };
+    auto dialog_database = DialogDatabase{ content };
     if (not text_database.contains("intro")) {
         throw std::runtime_error{ "Missing intro text." };
     }
-
-    auto terminal = Terminal{};
     text_database.get("intro").print(terminal);
 
+    auto world = World{ content };
+    auto const reload = [&] {
+        if (watcher.has_value()) {
+            reload_changed_files(watcher.value(), world, dialog_database, text_database, synonyms_dict, ignore_list);
+        }
+    };
     try {
-        auto world = World{};
         while (true) {
-            auto const command = get_next_command(terminal, ignore_list, world);
+            auto const command = get_next_command(terminal, ignore_list, world, reload);
             if (not world.process_command(command, terminal, synonyms_dict, text_database, dialog_database)) {
                 break;
             }
         }
+    } catch (EndOfInput const&) {
+        // Running out of input ends the game just like quitting it.
+    }
+}
+
+// Plays the commands of a script as fast as possible and without a screen. If a path is given, the
+// transcript of the session is written to it.
+static int replay(
+    std::filesystem::path const& script_path,
+    std::optional<std::filesystem::path> const& transcript_path
+) {
+    try {
+        auto input = ScriptInput{ read_file(script_path) };
+        auto const content = load_game_content(true);
+        auto watcher = std::optional<ContentWatcher>{};
+        auto transcript = TranscriptTerminal{ input };
+        auto null_terminal = NullTerminal{ input };
+        auto& terminal = transcript_path.has_value() ? static_cast<Terminal&>(transcript) : null_terminal;
+        // The script may end at any point of the game.
+        play(terminal, content, watcher);
+        if (transcript_path.has_value()) {
+            auto file = std::ofstream{ transcript_path.value(), std::ios::binary };
+            file << transcript.transcript();
+            if (not file) {
+                throw std::runtime_error{ "Unable to write " + transcript_path.value().string() };
+            }
+        }
+    } catch (std::exception const& exception) {
+        std::cerr << "Error: " << exception.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static int compile_world(std::filesystem::path const& path) {
+    try {
+        auto const sources = collect_source_files();
+        auto const content = load_content(sources);
+        // Resolve everything once so that broken content is rejected before it ends up in the image.
+        World{ content }.instantiate_all_rooms();
+        std::ignore = DialogDatabase{ content };
+        world_image::compile(content, sources, path);
+    } catch (std::exception const& exception) {
+        std::cerr << "Error: " << exception.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    std::cout << "World image written to " << path.string() << '\n';
+    return EXIT_SUCCESS;
+}
+
+static int generate_word_tables(std::filesystem::path const& path) {
+    try {
+        word_tables::generate(load_content(collect_source_files()), path);
+    } catch (std::exception const& exception) {
+        std::cerr << "Error: " << exception.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int const argc, char** const argv) {
+    using namespace c2k::Utf8Literals;
+
+    auto const arguments = std::vector<std::string_view>(argv + 1, argv + argc);
+    if (not arguments.empty() and arguments.front() == "compile-world") {
+        return compile_world(arguments.size() >= 2 ? arguments.at(1) : world_image::default_path);
+    }
+    if (arguments.size() == 2 and arguments.front() == "generate-word-tables") {
+        return generate_word_tables(arguments.at(1));
+    }
+    if ((arguments.size() == 2 or arguments.size() == 3) and arguments.front() == "replay") {
+        auto const transcript_path =
+            arguments.size() == 3 ? std::optional<std::filesystem::path>{ arguments.at(2) } : std::nullopt;
+        return replay(arguments.at(1), transcript_path);
+    }
+
+    // In watch mode, content files are reloaded as soon as they change. The watcher is set up before
+    // the content is loaded, so that no change gets lost in between.
+    auto watcher = std::optional<ContentWatcher>{};
+    if (not arguments.empty() and arguments.front() == "watch") {
+        watcher.emplace();
+    }
+
+    auto const pacing = pacing_from_environment();
+    auto const content = load_game_content(not watcher.has_value());
+    auto input = StdinInput{};
+    auto terminal = AnsiTerminal{ input };
+    if (pacing.has_value()) {
+        terminal.set_pacing(pacing.value());
+    }
+
+    try {
+        play(terminal, content, watcher);
     } catch (std::exception const& exception) {
         std::cerr << "Error: " << exception.what() << '\n';
     }
     terminal.println();
     terminal.println();
     terminal.println("Drücke Enter, um das Spiel zu beenden.");
-    std::ignore = terminal.read_line();
+    try {
+        std::ignore = terminal.read_line();
+    } catch (EndOfInput const&) {
+        // There's nobody left to press Enter.
+    }
 }
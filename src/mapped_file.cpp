@@ -0,0 +1,59 @@
+#include "mapped_file.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+    auto file = std::ifstream{ path, std::ios::binary };
+    if (not file) {
+        throw std::runtime_error{ "Unable to open file: " + path.string() };
+    }
+    m_buffer.resize(static_cast<std::size_t>(std::filesystem::file_size(path)));
+    if (not file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()))) {
+        throw std::runtime_error{ "Failed to read file: " + path.string() };
+    }
+    m_data = m_buffer;
+}
+
+MappedFile::~MappedFile() noexcept = default;
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+    auto const descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error{ "Unable to open file: " + path.string() };
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error{ "Unable to determine size of file: " + path.string() };
+    }
+    auto const size = static_cast<std::size_t>(status.st_size);
+    if (size == 0) {
+        close(descriptor);
+        return;
+    }
+    auto const address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping stays valid after the descriptor has been closed.
+    close(descriptor);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error{ "Unable to map file: " + path.string() };
+    }
+    m_data = std::span{ static_cast<std::byte const*>(address), size };
+}
+
+MappedFile::~MappedFile() noexcept {
+    if (not m_data.empty()) {
+        munmap(const_cast<std::byte*>(m_data.data()), m_data.size());
+    }
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped, otherwise
+// it is read into a buffer.
+class MappedFile final {
+private:
+    std::span<std::byte const> m_data;
+    std::vector<std::byte> m_buffer;
+
+public:
+    explicit MappedFile(std::filesystem::path const& path);
+
+    MappedFile(MappedFile const& other) = delete;
+    MappedFile(MappedFile&& other) noexcept = delete;
+    MappedFile& operator=(MappedFile const& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept = delete;
+
+    ~MappedFile() noexcept;
+
+    [[nodiscard]] std::span<std::byte const> data() const {
+        return m_data;
+    }
+};
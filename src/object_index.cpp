@@ -0,0 +1,119 @@
+#include "object_index.hpp"
+#include <algorithm>
+
+// Two typos for longer words, one for shorter ones. Very short words must match exactly, because
+// almost everything is similar to them.
+[[nodiscard]] static usize max_distance(usize const length) {
+    if (length < 3) {
+        return 0;
+    }
+    return length < 6 ? 1 : 2;
+}
+
+// The content is valid UTF-8, so no validation is needed.
+[[nodiscard]] static std::u32string code_points(std::string_view const text) {
+    auto result = std::u32string{};
+    for (auto i = usize{ 0 }; i < text.size();) {
+        auto const lead = static_cast<u8>(text[i]);
+        auto const length = usize{ lead < 0x80 ? 1u : lead < 0xE0 ? 2u : lead < 0xF0 ? 3u : 4u };
+        auto code_point = static_cast<char32_t>(length == 1 ? lead : lead & (0x7Fu >> length));
+        for (auto j = usize{ 1 }; j < length and i + j < text.size(); ++j) {
+            code_point = (code_point << 6) | (static_cast<u8>(text[i + j]) & 0x3F);
+        }
+        result.push_back(code_point);
+        i += length;
+    }
+    return result;
+}
+
+void ObjectIndex::insert(c2k::Utf8StringView const folded_name) {
+    if (auto const find_iterator = m_names.find(folded_name.view()); find_iterator != m_names.end()) {
+        ++find_iterator->second;
+        return;
+    }
+    m_names.emplace(std::string{ folded_name.view() }, usize{ 1 });
+    set_active(folded_name.view(), true);
+}
+
+void ObjectIndex::erase(c2k::Utf8StringView const folded_name) {
+    auto const find_iterator = m_names.find(folded_name.view());
+    if (find_iterator == m_names.end()) {
+        return;
+    }
+    if (--find_iterator->second == 0) {
+        m_names.erase(find_iterator);
+        set_active(folded_name.view(), false);
+    }
+}
+
+// Nodes of names that are no longer active stay in the trie until it is cleared, so that names can
+// come and go without restructuring it.
+void ObjectIndex::set_active(std::string_view const name, bool const active) {
+    auto& node = m_trie.at(find_or_insert_node(code_points(name)));
+    node.name = name;
+    node.active = active;
+}
+
+[[nodiscard]] u32 ObjectIndex::find_or_insert_node(std::u32string_view const name) {
+    auto node = u32{ 0 };
+    for (auto const c : name) {
+        auto& children = m_trie.at(node).children;
+        auto const find_iterator =
+            std::find_if(children.cbegin(), children.cend(), [&](auto const& child) { return child.first == c; });
+        if (find_iterator != children.cend()) {
+            node = find_iterator->second;
+            continue;
+        }
+        auto const child = static_cast<u32>(m_trie.size());
+        m_trie.at(node).children.emplace_back(c, child);
+        m_trie.emplace_back();
+        node = child;
+    }
+    return node;
+}
+
+[[nodiscard]] std::vector<std::string_view> ObjectIndex::find_similar(c2k::Utf8StringView const folded_word) const {
+    auto const word = code_points(folded_word.view());
+    auto best_distance = max_distance(word.size());
+    auto result = std::vector<std::string_view>{};
+
+    // Depth-first search through the trie, computing one row of the Levenshtein matrix per node. A
+    // subtree is skipped as soon as no entry of the row is within the best distance found so far.
+    struct Frame final {
+        u32 node;
+        std::vector<usize> row;
+    };
+    auto first_row = std::vector<usize>(word.size() + 1);
+    for (auto i = usize{ 0 }; i < first_row.size(); ++i) {
+        first_row.at(i) = i;
+    }
+    auto stack = std::vector{ Frame{ 0, std::move(first_row) } };
+    while (not stack.empty()) {
+        auto const [node_index, row] = std::move(stack.back());
+        stack.pop_back();
+        auto const& node = m_trie.at(node_index);
+        if (node.active and row.back() <= best_distance) {
+            if (row.back() < best_distance) {
+                best_distance = row.back();
+                result.clear();
+            }
+            result.push_back(node.name);
+        }
+        for (auto const& [c, child] : node.children) {
+            // Rows are never empty: the entry for the empty prefix is appended first, and the others refer to it.
+            auto next_row = std::vector<usize>{};
+            next_row.reserve(row.size());
+            next_row.push_back(row.front() + 1);
+            auto minimum = next_row.back();
+            for (auto i = usize{ 1 }; i < row.size(); ++i) {
+                auto const substitution = row.at(i - 1) + (word.at(i - 1) == c ? 0 : 1);
+                next_row.push_back(std::min({ row.at(i) + 1, next_row.back() + 1, substitution }));
+                minimum = std::min(minimum, next_row.back());
+            }
+            if (minimum <= best_distance) {
+                stack.push_back(Frame{ child, std::move(next_row) });
+            }
+        }
+    }
+    return result;
+}
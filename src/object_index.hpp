@@ -0,0 +1,52 @@
+#pragma once
+
+#include <lib2k/types.hpp>
+#include <lib2k/utf8/string_view.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "utils.hpp"
+
+// The names of all objects the player can currently refer to, case-folded. The same name can belong
+// to several objects, so every name is counted. The index is kept up to date while objects move,
+// so that parsing a command is a hash lookup per word, independent of the number of objects.
+//
+// For words that aren't names of objects (e.g. because of typos), the names are also kept in a trie
+// over their code points. Searching it for similar names only visits the prefixes that are still
+// within the maximum edit distance of the word.
+class ObjectIndex final {
+private:
+    struct TrieNode final {
+        std::vector<std::pair<char32_t, u32>> children;
+        std::string name;  // Only set for nodes that end a name.
+        bool active = false;  // Whether the name belongs to any object right now.
+    };
+
+    std::unordered_map<std::string, usize, StringHash, std::equal_to<>> m_names;
+    std::vector<TrieNode> m_trie = std::vector<TrieNode>(1);
+
+public:
+    // Like the lookups, these expect case-folded names, so that objects can pass the names they keep
+    // folded anyway without folding them again.
+    void insert(c2k::Utf8StringView folded_name);
+    void erase(c2k::Utf8StringView folded_name);
+
+    void clear() {
+        m_names.clear();
+        m_trie = std::vector<TrieNode>(1);
+    }
+
+    // Expects a name that is already case-folded, like the words of a sanitized command.
+    [[nodiscard]] bool contains(c2k::Utf8StringView const folded_name) const {
+        return m_names.find(folded_name.view()) != m_names.cend();
+    }
+
+    // Returns the names with the smallest Levenshtein distance to the (case-folded) word, as long as
+    // that distance is small enough for the length of the word. Returns nothing if there is no such name.
+    [[nodiscard]] std::vector<std::string_view> find_similar(c2k::Utf8StringView folded_word) const;
+
+private:
+    [[nodiscard]] u32 find_or_insert_node(std::u32string_view name);
+    void set_active(std::string_view name, bool active);
+};
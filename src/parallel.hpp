@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <lib2k/types.hpp>
+#include <thread>
+#include <vector>
+
+// Calls `function` for every index in [0, count) using all available cores. The calling thread
+// takes part in the work. `function` must not throw.
+template<std::invocable<usize> Function>
+void parallel_for(usize const count, Function const& function) {
+    auto const num_threads = std::clamp(usize{ std::thread::hardware_concurrency() }, usize{ 1 }, std::max(count, usize{ 1 }));
+    auto next_index = std::atomic<usize>{ 0 };
+    auto const work = [&] {
+        for (auto index = next_index++; index < count; index = next_index++) {
+            function(index);
+        }
+    };
+
+    auto workers = std::vector<std::jthread>{};
+    workers.reserve(num_threads - 1);
+    for (auto i = usize{ 1 }; i < num_threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    // The destructors of the workers join them.
+}
@@ -27,7 +27,7 @@ static std::optional<c2k::Utf8String> sanitized(c2k::Utf8StringView const view)
     return result;
 }
 
-[[nodiscard]] static WordList tokenize(c2k::Utf8StringView input, WordList const& ignore_list) {
+[[nodiscard]] static WordList tokenize(c2k::Utf8StringView input, IgnoreList const& ignore_list) {
     auto const views = input.split(" "_utf8view);
     auto tokens = std::vector<c2k::Utf8String>{};
     tokens.reserve(views.size());
@@ -39,8 +39,7 @@ static std::optional<c2k::Utf8String> sanitized(c2k::Utf8StringView const view)
         if (not token.has_value()) {
             continue;
         }
-        if (std::find(ignore_list.begin(), ignore_list.end(), c2k::Utf8StringView{ token.value() })
-            != ignore_list.cend()) {
+        if (ignore_list.contains(token.value())) {
             continue;
         }
         tokens.push_back(std::move(token).value());
@@ -50,87 +49,113 @@ static std::optional<c2k::Utf8String> sanitized(c2k::Utf8StringView const view)
 
 std::expected<Command, ParserError> parse_command(
     c2k::Utf8StringView const input,
-    WordList const& objects,
-    WordList const& ignore_list
+    ObjectIndex const& objects,
+    IgnoreList const& ignore_list
 ) {
     auto const tokens = tokenize(input, ignore_list);
 
-    auto const is_object = [&objects](c2k::Utf8String const& object) {
-        return std::find_if(
-                   objects.cbegin(),
-                   objects.cend(),
-                   [&](auto const& current) { return current.to_lowercase() == object.to_lowercase(); }
-               )
-               != objects.cend();
+    // The tokens are already case-folded by `sanitized()`. Words that aren't objects are resolved
+    // to the most similar object, if that's unambiguous.
+    auto const resolve_object = [&objects](c2k::Utf8String const& word) -> std::expected<c2k::Utf8String, ParserError> {
+        if (objects.contains(word)) {
+            return word;
+        }
+        auto similar = objects.find_similar(word);
+        if (similar.empty()) {
+            return std::unexpected{ UnknownObject{ word } };
+        }
+        if (similar.size() == 1) {
+            return c2k::Utf8String{ std::string{ similar.front() } };
+        }
+        std::sort(similar.begin(), similar.end());
+        auto candidates = std::vector<c2k::Utf8String>{};
+        for (auto const candidate : similar) {
+            candidates.emplace_back(std::string{ candidate });
+        }
+        return std::unexpected{ AmbiguousObject{ word, std::move(candidates) } };
     };
 
+    // Deciding between the different forms of a command only considers exact matches, so that
+    // adjectives aren't mistaken for typos of objects.
+    auto const is_object = [&objects](c2k::Utf8String const& word) { return objects.contains(word); };
+
     switch (tokens.size()) {
         case 1:
             // Verb.
             return Command{ tokens.at(0), std::nullopt, std::nullopt };
-        case 2:
+        case 2: {
             // Verb Subjective.
-            if (not is_object(tokens.at(1))) {
-                return std::unexpected{ UnknownObject{ tokens.at(1) } };
+            auto const subjective = resolve_object(tokens.at(1));
+            if (not subjective.has_value()) {
+                return std::unexpected{ subjective.error() };
             }
             return Command{
                 tokens.at(0),
-                Noun{ std::nullopt, tokens.at(1) },
+                Noun{ std::nullopt, subjective.value() },
                 std::nullopt
             };
-        case 3:
+        }
+        case 3: {
             // Verb Adjective Subjective or Verb Subjective Objective.
-            if (not is_object(tokens.at(2))) {
-                return std::unexpected{ UnknownObject{ tokens.at(2) } };
+            auto const last = resolve_object(tokens.at(2));
+            if (not last.has_value()) {
+                return std::unexpected{ last.error() };
             }
             if (is_object(tokens.at(1))) {
                 // Verb Subjective Objective.
                 return Command{
                     tokens.at(0),
                     Noun{ std::nullopt, tokens.at(1) },
-                    Noun{ std::nullopt, tokens.at(2) },
+                    Noun{ std::nullopt, last.value() },
                 };
             }
             // Verb Adjective Subjective.
             return Command{
                 tokens.at(0),
-                Noun{ tokens.at(1), tokens.at(2) },
+                Noun{ tokens.at(1), last.value() },
             };
-        case 4:
+        }
+        case 4: {
             // Verb Adjective Subjective Objective or Verb Subjective Adjective Objective.
-            if (not is_object(tokens.at(3))) {
-                return std::unexpected{ UnknownObject{ tokens.at(3) } };
+            auto const objective = resolve_object(tokens.at(3));
+            if (not objective.has_value()) {
+                return std::unexpected{ objective.error() };
             }
             if (is_object(tokens.at(1))) {
                 // Verb Subjective Adjective Objective.
                 return Command{
                     tokens.at(0),
                     Noun{ std::nullopt, tokens.at(1) },
-                    Noun{ tokens.at(2), tokens.at(3) },
+                    Noun{ tokens.at(2), objective.value() },
                 };
             }
-            if (not is_object(tokens.at(2))) {
-                return std::unexpected{ UnknownObject{ tokens.at(2) } };
+            auto const subjective = resolve_object(tokens.at(2));
+            if (not subjective.has_value()) {
+                return std::unexpected{ subjective.error() };
             }
             // Verb Adjective Subjective Objective.
             return Command{
                 tokens.at(0),
-                Noun{ tokens.at(1), tokens.at(2) },
-                Noun{ std::nullopt, tokens.at(3) },
+                Noun{ tokens.at(1), subjective.value() },
+                Noun{ std::nullopt, objective.value() },
             };
-        case 5:
+        }
+        case 5: {
             // Verb Adjective Subjective Adjective Objective.
-            if (not is_object(tokens.at(2))) {
-                return std::unexpected{ UnknownObject{ tokens.at(2) } };
+            auto const subjective = resolve_object(tokens.at(2));
+            if (not subjective.has_value()) {
+                return std::unexpected{ subjective.error() };
             }
-            if (not is_object(tokens.at(4))) {
-                return std::unexpected{ UnknownObject{ tokens.at(4) } };
+            auto const objective = resolve_object(tokens.at(4));
+            if (not objective.has_value()) {
+                return std::unexpected{ objective.error() };
             }
             return Command{
                 tokens.at(0),
-                Noun{ tokens.at(1), tokens.at(2) },
-                Noun{ tokens.at(3), tokens.at(4) },
+                Noun{ tokens.at(1), subjective.value() },
+                Noun{ tokens.at(3), objective.value() },
             };
+        }
         case 0:
         default:
             return std::unexpected{ SyntaxError{} };
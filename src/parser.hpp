@@ -6,6 +6,8 @@
 #include <variant>
 #include <vector>
 #include "command.hpp"
+#include "ignore_list.hpp"
+#include "object_index.hpp"
 #include "utils.hpp"
 #include "word_list.hpp"
 
@@ -15,7 +17,13 @@ struct UnknownObject {
     c2k::Utf8String name;
 };
 
-using ParserError = std::variant<SyntaxError, UnknownObject>;
+// The name is a typo of several objects that are equally similar to it.
+struct AmbiguousObject {
+    c2k::Utf8String name;
+    std::vector<c2k::Utf8String> candidates;
+};
+
+using ParserError = std::variant<SyntaxError, UnknownObject, AmbiguousObject>;
 
 inline std::ostream& operator<<(std::ostream& ostream, ParserError const& error) {
     return std::visit(
@@ -24,9 +32,23 @@ inline std::ostream& operator<<(std::ostream& ostream, ParserError const& error)
             [&](UnknownObject const& object) -> std::ostream& {
                 return ostream << "Ich kenne kein Objekt namens '" << object.name << "'.";
             },
+            [&](AmbiguousObject const& object) -> std::ostream& {
+                ostream << "Meinst du ";
+                for (auto i = usize{ 0 }; i < object.candidates.size(); ++i) {
+                    if (i > 0) {
+                        ostream << (i + 1 == object.candidates.size() ? " oder " : ", ");
+                    }
+                    ostream << "'" << object.candidates.at(i) << "'";
+                }
+                return ostream << "?";
+            },
         },
         error
     );
 }
 
-[[nodiscard]] std::expected<Command, ParserError> parse_command(c2k::Utf8StringView input, WordList const& objects, WordList const& ignore_list);
+[[nodiscard]] std::expected<Command, ParserError> parse_command(
+    c2k::Utf8StringView input,
+    ObjectIndex const& objects,
+    IgnoreList const& ignore_list
+);
@@ -0,0 +1,68 @@
+#include "perfect_hash.hpp"
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+// Finds a seed that maps all given keys to distinct free slots.
+[[nodiscard]] static u32 find_seed(
+    std::vector<std::string_view> const& keys,
+    std::span<usize const> const bucket,
+    std::vector<bool> const& taken
+) {
+    auto slots = std::vector<usize>{};
+    for (auto seed = u32{ 1 }; seed < std::numeric_limits<u32>::max(); ++seed) {
+        slots.clear();
+        for (auto const key : bucket) {
+            auto const slot = perfect_hash::hash(keys.at(key), seed) % keys.size();
+            if (taken.at(slot) or std::find(slots.cbegin(), slots.cend(), slot) != slots.cend()) {
+                break;
+            }
+            slots.push_back(slot);
+        }
+        if (slots.size() == bucket.size()) {
+            return seed;
+        }
+    }
+    throw std::runtime_error{ "Unable to find a perfect hash function." };
+}
+
+namespace perfect_hash {
+    [[nodiscard]] Layout build(std::vector<std::string_view> const& keys) {
+        auto sorted_keys = keys;
+        std::sort(sorted_keys.begin(), sorted_keys.end());
+        if (auto const duplicate = std::adjacent_find(sorted_keys.cbegin(), sorted_keys.cend());
+            duplicate != sorted_keys.cend()) {
+            throw std::runtime_error{ "Duplicate key \"" + std::string{ *duplicate } + "\"." };
+        }
+
+        auto buckets = std::vector<std::vector<usize>>(bucket_count(keys.size()));
+        for (auto i = usize{ 0 }; i < keys.size(); ++i) {
+            buckets.at(hash(keys.at(i), 0) % buckets.size()).push_back(i);
+        }
+        auto order = std::vector<usize>(buckets.size());
+        for (auto i = usize{ 0 }; i < order.size(); ++i) {
+            order.at(i) = i;
+        }
+        // Larger buckets are harder to place, so they go first while most slots are still free.
+        std::stable_sort(order.begin(), order.end(), [&](usize const lhs, usize const rhs) {
+            return buckets.at(lhs).size() > buckets.at(rhs).size();
+        });
+
+        auto layout = Layout{ std::vector<u32>(buckets.size()), std::vector<usize>(keys.size()) };
+        auto taken = std::vector<bool>(keys.size());
+        for (auto const bucket : order) {
+            if (buckets.at(bucket).empty()) {
+                break;
+            }
+            auto const seed = find_seed(keys, buckets.at(bucket), taken);
+            layout.seeds.at(bucket) = seed;
+            for (auto const key : buckets.at(bucket)) {
+                auto const slot = hash(keys.at(key), seed) % keys.size();
+                taken.at(slot) = true;
+                layout.slots.at(slot) = key;
+            }
+        }
+        return layout;
+    }
+}  // namespace perfect_hash
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <lib2k/types.hpp>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Minimal perfect hashing for fixed sets of distinct string keys. The keys are distributed into buckets
+// by a first hash. Then, starting with the largest bucket, a seed is searched for each bucket, for which
+// a second hash maps all keys of the bucket to free slots. A lookup computes both hashes and compares
+// the key with the single candidate in its slot.
+namespace perfect_hash {
+    [[nodiscard]] constexpr usize bucket_count(usize const key_count) {
+        return key_count / 2 + 1;
+    }
+
+    // FNV-1a, followed by the finalizer of MurmurHash3 so that different seeds result in independent hashes.
+    [[nodiscard]] constexpr u32 hash(std::string_view const key, u32 const seed) {
+        auto result = u32{ 2166136261 } ^ (seed * u32{ 0x9E3779B9 });
+        for (auto const c : key) {
+            result = (result ^ static_cast<u8>(c)) * u32{ 16777619 };
+        }
+        result ^= result >> 16;
+        result *= u32{ 0x85EBCA6B };
+        result ^= result >> 13;
+        result *= u32{ 0xC2B2AE35 };
+        result ^= result >> 16;
+        return result;
+    }
+
+    struct Layout final {
+        std::vector<u32> seeds;    // The seed of every bucket.
+        std::vector<usize> slots;  // The index of the key that belongs into every slot.
+    };
+
+    // Throws if the keys are not distinct.
+    [[nodiscard]] Layout build(std::vector<std::string_view> const& keys);
+
+    // A table whose layout has been computed by `build()`, so that it can be a compile-time constant.
+    template<typename Value, usize size>
+    struct Table final {
+        std::array<u32, bucket_count(size)> seeds;
+        std::array<std::pair<std::string_view, Value>, size> slots;
+
+        // Returns the value of the key, or a value-initialized `Value` if the key is not part of the table.
+        [[nodiscard]] constexpr Value find(std::string_view const key) const {
+            if constexpr (size == 0) {
+                return Value{};
+            } else {
+                auto const seed = seeds[hash(key, 0) % seeds.size()];
+                auto const& [candidate, value] = slots[hash(key, seed) % size];
+                return candidate == key ? value : Value{};
+            }
+        }
+    };
+}  // namespace perfect_hash
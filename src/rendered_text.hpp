@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <lib2k/types.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Text that has been rendered into a buffer, together with the offsets at which it can be split up
+// without tearing apart a UTF-8 sequence or an escape sequence.
+class RenderedText final {
+private:
+    std::string m_bytes;
+    std::vector<usize> m_character_ends;
+    std::vector<usize> m_line_ends;
+
+public:
+    // Must only be called with complete UTF-8 sequences.
+    void append_text(std::string_view const text) {
+        for (auto i = usize{ 0 }; i < text.size(); ++i) {
+            m_bytes.push_back(text.at(i));
+            auto const is_continuation = i + 1 < text.size() and (static_cast<u8>(text.at(i + 1)) & 0xC0) == 0x80;
+            if (not is_continuation) {
+                m_character_ends.push_back(m_bytes.size());
+            }
+        }
+    }
+
+    // Appends the bytes of another text within the given range, which must not split any sequence.
+    void append(RenderedText const& other, usize const begin, usize const end) {
+        auto const offset = m_bytes.size() - begin;
+        m_bytes += std::string_view{ other.m_bytes }.substr(begin, end - begin);
+        auto const first = std::upper_bound(other.m_character_ends.cbegin(), other.m_character_ends.cend(), begin);
+        auto const last = std::upper_bound(first, other.m_character_ends.cend(), end);
+        for (auto it = first; it != last; ++it) {
+            m_character_ends.push_back(*it + offset);
+        }
+    }
+
+    void append_escape(std::string_view const sequence) {
+        m_bytes += sequence;
+    }
+
+    void end_line() {
+        append_text("\n");
+        m_line_ends.push_back(m_bytes.size());
+    }
+
+    [[nodiscard]] std::string_view bytes() const {
+        return m_bytes;
+    }
+
+    [[nodiscard]] std::vector<usize> const& character_ends() const {
+        return m_character_ends;
+    }
+
+    [[nodiscard]] std::vector<usize> const& line_ends() const {
+        return m_line_ends;
+    }
+};
@@ -5,25 +5,28 @@
 #include "exit.hpp"
 #include "file_parser.hpp"
 #include "inventory.hpp"
+#include "styled_text.hpp"
 
 class Room final {
 private:
     c2k::Utf8String m_name;
-    c2k::Utf8String m_description;
-    c2k::Utf8String m_on_entry;
-    c2k::Utf8String m_on_exit;
+    c2k::Utf8String m_folded_name;
+    StyledText m_description;
+    StyledText m_on_entry;
+    StyledText m_on_exit;
     Inventory m_inventory;
     std::vector<Exit> m_exits;
 
 public:
     explicit Room(
         c2k::Utf8String name,
-        c2k::Utf8String description,
-        c2k::Utf8String on_entry,
-        c2k::Utf8String on_exit,
+        StyledText description,
+        StyledText on_entry,
+        StyledText on_exit,
         std::vector<Exit> exits
     )
         : m_name{ std::move(name) },
+          m_folded_name{ m_name.to_lowercase() },
           m_description{ std::move(description) },
           m_on_entry{ std::move(on_entry) },
           m_on_exit{ std::move(on_exit) },
@@ -35,15 +38,20 @@ public:
         return m_name;
     }
 
-    [[nodiscard]] c2k::Utf8String const& description() const {
+    // The name in lowercase, for comparing it to the words of commands.
+    [[nodiscard]] c2k::Utf8String const& folded_name() const {
+        return m_folded_name;
+    }
+
+    [[nodiscard]] StyledText const& description() const {
         return m_description;
     }
 
-    [[nodiscard]] c2k::Utf8String const& on_entry() const {
+    [[nodiscard]] StyledText const& on_entry() const {
         return m_on_entry;
     }
 
-    [[nodiscard]] c2k::Utf8String const& on_exit() const {
+    [[nodiscard]] StyledText const& on_exit() const {
         return m_on_exit;
     }
 
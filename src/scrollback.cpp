@@ -0,0 +1,52 @@
+#include "scrollback.hpp"
+#include <algorithm>
+#include "utils.hpp"
+
+void Scrollback::add(StyledText const& paragraph) {
+    m_entries.emplace_back(paragraph);
+    if (m_entries.size() > max_entries) {
+        m_entries.pop_front();
+    }
+}
+
+void Scrollback::add(std::string_view const bytes) {
+    // Consecutive raw output (e.g. line breaks, prompts and colors) is merged into a single entry.
+    if (not m_entries.empty()) {
+        if (auto const previous = std::get_if<std::string>(&m_entries.back())) {
+            *previous += bytes;
+            return;
+        }
+    }
+    m_entries.emplace_back(std::string{ bytes });
+    if (m_entries.size() > max_entries) {
+        m_entries.pop_front();
+    }
+}
+
+[[nodiscard]] std::string Scrollback::render(int const width, int const height) const {
+    // Walk back from the most recent entry until the screen is full.
+    auto first = m_entries.size();
+    auto lines = usize{ 0 };
+    while (first > 0 and lines < static_cast<usize>(height)) {
+        --first;
+        lines += std::visit(
+            Overloaded{
+                [&](StyledText const& paragraph) { return paragraph.layout(width).line_ends().size(); },
+                [](std::string const& raw) { return static_cast<usize>(std::ranges::count(raw, '\n')); },
+            },
+            m_entries.at(first)
+        );
+    }
+
+    auto result = std::string{};
+    for (auto i = first; i < m_entries.size(); ++i) {
+        std::visit(
+            Overloaded{
+                [&](StyledText const& paragraph) { result += paragraph.layout(width).bytes(); },
+                [&](std::string const& raw) { result += raw; },
+            },
+            m_entries.at(i)
+        );
+    }
+    return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <deque>
+#include <lib2k/types.hpp>
+#include <string>
+#include <string_view>
+#include <variant>
+#include "styled_text.hpp"
+
+// The most recent output since the screen has been cleared, so that the screen can be redrawn after its size
+// has changed. Paragraphs are kept as styled text, which allows wrapping them again for the new width.
+class Scrollback final {
+private:
+    using Entry = std::variant<StyledText, std::string>;
+
+    // More than enough to fill any screen. Older entries are dropped.
+    static constexpr auto max_entries = usize{ 256 };
+
+    std::deque<Entry> m_entries;
+
+public:
+    void clear() {
+        m_entries.clear();
+    }
+
+    void add(StyledText const& paragraph);
+    void add(std::string_view bytes);
+
+    // Renders only the most recent entries that fit on a screen of the given size. Their layouts for
+    // the width are computed once and then cached in the texts.
+    [[nodiscard]] std::string render(int width, int height) const;
+};
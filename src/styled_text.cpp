@@ -0,0 +1,66 @@
+#include "styled_text.hpp"
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include "terminal.hpp"
+
+StyledText::StyledText(c2k::Utf8StringView const text) : m_data{ std::make_shared<Data>() } {
+    auto& styled_words = m_data->styled_words;
+    for (auto const& word : text.split(" ")) {
+        auto width = static_cast<int>(word.calculate_char_width());
+        auto to_print = word.view();
+        auto const is_headline = width >= 1 and word.front() == '#';
+        if (is_headline) {
+            --width;
+            to_print.remove_prefix(1);
+        }
+
+        auto const begin = styled_words.bytes().size();
+        if (not is_headline and std::ranges::count(to_print, '*') == 2) {
+            auto const first = to_print.find('*');
+            auto const second = to_print.find('*', first + 1);
+            styled_words.append_text(to_print.substr(0, first));
+            styled_words.append_escape(ansi::text_color(TextColor::BrightYellow));
+            styled_words.append_text(to_print.substr(first + 1, second - first - 1));
+            styled_words.append_escape(ansi::reset);
+            styled_words.append_text(to_print.substr(second + 1));
+        } else {
+            styled_words.append_text(to_print);
+        }
+        m_data->words.push_back(Word{ begin, styled_words.bytes().size(), width, is_headline });
+    }
+}
+
+[[nodiscard]] RenderedText const& StyledText::layout(int const width) const {
+    auto& layouts = m_data->layouts;
+    auto const find_iterator =
+        std::find_if(layouts.cbegin(), layouts.cend(), [&](auto const& layout) { return layout.first == width; });
+    if (find_iterator != layouts.cend()) {
+        return find_iterator->second;
+    }
+    if (layouts.size() >= max_cached_layouts) {
+        layouts.erase(layouts.begin());
+    }
+    return layouts.emplace_back(width, wrap(width)).second;
+}
+
+[[nodiscard]] RenderedText StyledText::wrap(int const width) const {
+    auto result = RenderedText{};
+    auto x = 0;
+    for (auto const& word : m_data->words) {
+        if (word.is_headline) {
+            result.append_escape(ansi::text_color(TextColor::BrightWhite));
+        }
+        if (word.width > width - x) {
+            x = 0;
+            result.end_line();
+        }
+        result.append(m_data->styled_words, word.begin, word.end);
+        x += word.width + 1;
+        if (x < width) {
+            result.append_text(" ");
+        }
+    }
+    result.append_escape(ansi::reset);
+    return result;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <lib2k/types.hpp>
+#include <lib2k/utf8/string_view.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "rendered_text.hpp"
+
+// Text whose markup (`#headline` words and `*highlighted*` parts) has been parsed into styled words once,
+// so that printing it doesn't need to scan it again. The line breaks for a terminal width are computed
+// when the text is printed with that width for the first time. Copies share the words and the layouts.
+class StyledText final {
+private:
+    struct Word final {
+        usize begin;
+        usize end;
+        int width;
+        bool is_headline;
+    };
+
+    struct Data final {
+        RenderedText styled_words;  // All words after each other, without any separators.
+        std::vector<Word> words;
+        std::vector<std::pair<int, RenderedText>> layouts;
+    };
+
+    static constexpr auto max_cached_layouts = usize{ 4 };
+
+    std::shared_ptr<Data> m_data;
+
+public:
+    explicit StyledText(c2k::Utf8StringView text);
+
+    // The returned layout stays valid until a layout for another width is requested.
+    [[nodiscard]] RenderedText const& layout(int width) const;
+
+private:
+    [[nodiscard]] RenderedText wrap(int width) const;
+};
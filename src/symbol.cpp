@@ -0,0 +1,50 @@
+#include "symbol.hpp"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "utils.hpp"
+
+// Rooms can be instantiated by a background thread, which interns symbols as well.
+struct SymbolTable final {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, u32, StringHash, std::equal_to<>> ids;  // Looked up by view, without copying.
+    std::deque<c2k::Utf8String> names;  // Never reallocates, so references to the names stay valid.
+};
+
+[[nodiscard]] static SymbolTable& symbol_table() {
+    static auto table = SymbolTable{};
+    return table;
+}
+
+Symbol::Symbol(c2k::Utf8StringView const name) {
+    auto& table = symbol_table();
+    if (auto const symbol = find(name)) {
+        m_id = symbol->id();
+        return;
+    }
+    auto const lock = std::unique_lock{ table.mutex };
+    auto const [iterator, inserted] =
+        table.ids.try_emplace(std::string{ name.view() }, static_cast<u32>(table.names.size()));
+    if (inserted) {
+        table.names.emplace_back(name);
+    }
+    m_id = iterator->second;
+}
+
+[[nodiscard]] tl::optional<Symbol> Symbol::find(c2k::Utf8StringView const name) {
+    auto& table = symbol_table();
+    auto const lock = std::shared_lock{ table.mutex };
+    auto const find_iterator = table.ids.find(name.view());
+    if (find_iterator == table.ids.cend()) {
+        return tl::nullopt;
+    }
+    return Symbol{ find_iterator->second };
+}
+
+[[nodiscard]] c2k::Utf8String const& Symbol::name() const {
+    auto& table = symbol_table();
+    auto const lock = std::shared_lock{ table.mutex };
+    return table.names.at(m_id);
+}
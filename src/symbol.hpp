@@ -0,0 +1,51 @@
+#pragma once
+
+#include <functional>
+#include <lib2k/types.hpp>
+#include <lib2k/utf8/string.hpp>
+#include <lib2k/utf8/string_view.hpp>
+#include <ranges>
+#include <tl/optional.hpp>
+#include <vector>
+
+// References to content (items, rooms, dialogs, labels and flags) are interned into a global symbol
+// table while the content is loaded. A symbol is a dense 32-bit ID, so symbols are cheap to store,
+// compare and hash. Their names are only needed for display and error messages.
+class Symbol final {
+private:
+    u32 m_id;
+
+    explicit Symbol(u32 const id)
+        : m_id{ id } {}
+
+public:
+    // Interns the name if it hasn't been interned before.
+    explicit Symbol(c2k::Utf8StringView name);
+
+    // Returns the symbol with the given name without interning it, e.g. for names entered by the player.
+    [[nodiscard]] static tl::optional<Symbol> find(c2k::Utf8StringView name);
+
+    [[nodiscard]] u32 id() const {
+        return m_id;
+    }
+
+    [[nodiscard]] c2k::Utf8String const& name() const;
+
+    [[nodiscard]] bool operator==(Symbol const& other) const = default;
+};
+
+template<>
+struct std::hash<Symbol> {
+    [[nodiscard]] usize operator()(Symbol const symbol) const noexcept {
+        return symbol.id();
+    }
+};
+
+template<std::ranges::input_range Range>
+[[nodiscard]] std::vector<Symbol> intern_all(Range const& names) {
+    auto symbols = std::vector<Symbol>{};
+    for (auto const& name : names) {
+        symbols.emplace_back(name);
+    }
+    return symbols;
+}
@@ -1,53 +1,132 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <string>
+#include <tl/optional.hpp>
 #include <unordered_map>
+#include <vector>
+#include "content.hpp"
+#include "symbol.hpp"
+#include "utils.hpp"
 #include "word_list.hpp"
 
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+#include "builtin_words.hpp"
+#endif
+
 class SynonymsDict final {
 private:
-    static constexpr auto synonyms_directory = "synonyms";
-
-    std::unordered_map<c2k::Utf8String, WordList> m_word_lists;
+    std::unordered_map<Symbol, WordList> m_word_lists;
+    // Maps every word to the categories it belongs to, sorted by name. A word that is part of several
+    // lists is therefore always resolved to the same category.
+    std::unordered_map<std::string, std::vector<Symbol>, StringHash, std::equal_to<>> m_categories;
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+    // As long as the lists match the built-in table, it's used instead of the index. The categories
+    // are stored in the order of `builtin_words::synonym_list_names()`, i.e. sorted by name.
+    std::vector<Symbol> m_builtin_categories;
+#endif
 
 public:
-    SynonymsDict() {
-        using DirectoryIterator = std::filesystem::recursive_directory_iterator;
-        for (auto const& entry : DirectoryIterator{ synonyms_directory }) {
-            if (entry.path().extension() != ".list") {
-                continue;
+    explicit SynonymsDict(Content const& content) {
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        // Lists that match the built-in table don't have to be read at all.
+        if (builtin_words::matches_synonym_lists(content.synonyms)) {
+            for (auto const name : builtin_words::synonym_list_names()) {
+                m_builtin_categories.emplace_back(c2k::Utf8String{ std::string{ name } });
+            }
+            return;
+        }
+#endif
+        for (auto const& [name, contents] : content.synonyms) {
+            m_word_lists.emplace(Symbol{ name }, read_synonyms(contents));
+        }
+        build_index();
+    }
+
+    void reload(RawFile const& file) {
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        // The other lists are recovered from the built-in table, since they haven't been read.
+        if (not m_builtin_categories.empty()) {
+            for (auto const category : m_builtin_categories) {
+                m_word_lists.try_emplace(category);
             }
-            auto lines = c2k::Utf8String{ read_file(entry.path()) }.split("\n");
-            for (auto& line : lines) {
-                line = trim(line);
+            for (auto const& [word, mask] : builtin_words::synonyms()) {
+                for (auto lists = mask; lists != 0; lists &= lists - 1) {
+                    auto const category = m_builtin_categories.at(static_cast<usize>(std::countr_zero(lists)));
+                    m_word_lists.at(category).emplace_back(std::string{ word });
+                }
             }
-            erase_if(lines, [](auto const& line) { return line.is_empty(); });
-            m_word_lists.emplace(entry.path().stem().string(), std::move(lines));
+            m_builtin_categories.clear();
         }
+#endif
+        m_word_lists.insert_or_assign(Symbol{ file.name }, read_synonyms(file.contents));
+        build_index();
     }
 
     [[nodiscard]] bool is_synonym_of(c2k::Utf8StringView const word, c2k::Utf8StringView const category) const {
-        auto const find_iterator = m_word_lists.find(category);
-        if (find_iterator == m_word_lists.cend()) {
-            throw std::runtime_error{ "No word list named '" + std::string{ word.view() } + "' found." };
+        // The category is resolved once, so that the candidates are compared by their IDs instead of their names.
+        auto const category_symbol = Symbol::find(category);
+        if (not category_symbol or not is_category(category_symbol.value())) {
+            throw std::runtime_error{ "No word list named '" + std::string{ category.view() } + "' found." };
         }
-        for (auto const& synonym : find_iterator->second) {
-            if (word == synonym) {
-                return true;
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        if (not m_builtin_categories.empty()) {
+            for (auto mask = builtin_words::synonym_lists_of(word.view()); mask != 0; mask &= mask - 1) {
+                if (m_builtin_categories.at(static_cast<usize>(std::countr_zero(mask))) == category_symbol.value()) {
+                    return true;
+                }
             }
+            return false;
+        }
+#endif
+        if (auto const find_iterator = m_categories.find(word.view()); find_iterator != m_categories.cend()) {
+            return std::ranges::find(find_iterator->second, category_symbol.value()) != find_iterator->second.cend();
         }
         return false;
     }
 
-    // Try to get the category of a word. If no category is found, returns the word itself.
-    [[nodiscard]] c2k::Utf8String reverse_lookup(c2k::Utf8StringView const word) const {
+    // Try to get the category of a word. If the word isn't part of any list, it is its own category.
+    // Returns nothing if that category is unknown to the content.
+    [[nodiscard]] tl::optional<Symbol> find_category(c2k::Utf8StringView const word) const {
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        if (not m_builtin_categories.empty()) {
+            if (auto const mask = builtin_words::synonym_lists_of(word.view()); mask != 0) {
+                return m_builtin_categories.at(static_cast<usize>(std::countr_zero(mask)));
+            }
+            return Symbol::find(word);
+        }
+#endif
+        if (auto const find_iterator = m_categories.find(word.view()); find_iterator != m_categories.cend()) {
+            return find_iterator->second.front();
+        }
+        return Symbol::find(word);
+    }
+
+private:
+    [[nodiscard]] bool is_category(Symbol const symbol) const {
+#ifdef GUESS_WHAT_BUILTIN_WORDS
+        if (std::ranges::find(m_builtin_categories, symbol) != m_builtin_categories.cend()) {
+            return true;
+        }
+#endif
+        return m_word_lists.contains(symbol);
+    }
+
+    void build_index() {
+        m_categories.clear();
         for (auto const& [category, word_list] : m_word_lists) {
-            for (auto const& list_entry : word_list) {
-                if (word == list_entry) {
-                    return category;
+            for (auto const& word : word_list) {
+                auto& categories = m_categories[std::string{ word.view() }];
+                if (std::ranges::find(categories, category) == categories.cend()) {
+                    categories.push_back(category);
                 }
             }
         }
-        return word;
+        for (auto& [word, categories] : m_categories) {
+            std::ranges::sort(categories, [](Symbol const lhs, Symbol const rhs) {
+                return lhs.name().view() < rhs.name().view();
+            });
+        }
     }
 };
@@ -1,9 +1,13 @@
 #pragma once
 
-#include <atomic>
 #include <lib2k/utf8/string.hpp>
 #include <lib2k/utf8/string_view.hpp>
 #include <lib2k/types.hpp>
+#include <string>
+#include <string_view>
+#include "input_source.hpp"
+#include "rendered_text.hpp"
+#include "styled_text.hpp"
 
 enum class TextColor {
     Black = 30,
@@ -43,38 +47,76 @@ enum class BackgroundColor {
     BrightWhite = 107,
 };
 
-class Terminal final {
-public:
-    static constexpr auto width = 80;
-    static constexpr auto height = 24;
-    static inline std::atomic_bool s_initialized = false;
+namespace ansi {
+    [[nodiscard]] std::string text_color(TextColor color);
+
+    inline constexpr auto reset = std::string_view{ "\x1b[0m" };
+    inline constexpr auto clear_screen = std::string_view{ "\x1b[2J\x1b[H" };
+}  // namespace ansi
+
+// The interface through which the game talks to the player. Text is wrapped and styled here, while the
+// backends decide where the resulting bytes go. The input comes from a separate `InputSource`.
+class Terminal {
+private:
+    InputSource* m_input;
+    int m_width = 80;
+    int m_height = 24;
 
 public:
-    Terminal();
+    explicit Terminal(InputSource& input) : m_input{ &input } {}
 
     Terminal(Terminal const& other) = delete;
     Terminal(Terminal&& other) noexcept = delete;
     Terminal& operator=(Terminal const& other) = delete;
     Terminal& operator=(Terminal&& other) noexcept = delete;
 
-    ~Terminal() noexcept;
+    virtual ~Terminal() = default;
+
+    [[nodiscard]] int width() const {
+        return m_width;
+    }
+
+    [[nodiscard]] int height() const {
+        return m_height;
+    }
 
     void clear(bool delayed = false);
     void set_position(int x, int y);
     void print_raw(c2k::Utf8StringView text);
     void print(c2k::Utf8StringView text);
+    void print(StyledText const& text);
     void println();
     void println(c2k::Utf8StringView text);
-    [[nodiscard]] c2k::Utf8String read_line();
+    void println(StyledText const& text);
+    [[nodiscard]] virtual c2k::Utf8String read_line();
     void hide_cursor();
     void show_cursor();
     void set_text_color(TextColor color);
     void set_background_color(BackgroundColor color);
     void reset_colors();
 
+protected:
+    void resize(int const width, int const height) {
+        m_width = width;
+        m_height = height;
+    }
+
+    virtual void write(std::string_view bytes) = 0;
+
+    // Writes a paragraph, wrapped for the current width. Backends may reveal it gradually.
+    virtual void write_paragraph(StyledText const& text) {
+        write(text.layout(m_width).bytes());
+    }
+
+    virtual void write_clear() {
+        write(ansi::clear_screen);
+    }
+
+    // Writes the dots that precede a delayed `clear()`.
+    virtual void write_transition() {
+        write("...");
+    }
+
 private:
-    void enter_alternate_screen_buffer();
-    void exit_alternate_screen_buffer();
     [[nodiscard]] bool is_valid_position(int x, int y) const;
-    void print_wrapped(c2k::Utf8StringView text);
 };
@@ -2,9 +2,10 @@
 #include <lib2k/utf8/string_view.hpp>
 #include "utils.hpp"
 
-Text::Text(std::filesystem::path const& path) {
-    auto const text = read_file(path);
-    m_lines = text.split("\n");
+Text::Text(c2k::Utf8StringView const contents) {
+    for (auto const& line : contents.split("\n")) {
+        m_lines.emplace_back(line);
+    }
 }
 
 void Text::print(Terminal& terminal) const {
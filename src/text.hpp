@@ -1,14 +1,15 @@
 #pragma once
 
 #include <lib2k/utf8/string.hpp>
-#include <filesystem>
+#include <lib2k/utf8/string_view.hpp>
+#include "styled_text.hpp"
 #include "terminal.hpp"
 
 class Text final {
 private:
-    std::vector<c2k::Utf8String> m_lines;
+    std::vector<StyledText> m_lines;
 
 public:
-    explicit Text(std::filesystem::path const& path);
+    explicit Text(c2k::Utf8StringView contents);
     void print(Terminal& terminal) const;
 };
@@ -1,25 +1,24 @@
 #pragma once
 
-#include <filesystem>
 #include <unordered_map>
+#include "content.hpp"
 #include "text.hpp"
 
 class TextDatabase final {
 private:
-    static constexpr auto texts_directory = "texts";
     std::unordered_map<c2k::Utf8String, Text> m_texts;
 
 public:
-    TextDatabase() {
-        using DirectoryIterator = std::filesystem::recursive_directory_iterator;
-        for (auto const& entry : DirectoryIterator{ texts_directory }) {
-            if (entry.path().extension() != ".txt") {
-                continue;
-            }
-            m_texts.emplace(entry.path().stem().string(), Text{ entry.path() });
+    explicit TextDatabase(Content const& content) {
+        for (auto const& [name, contents] : content.texts) {
+            m_texts.emplace(name, Text{ contents });
         }
     }
 
+    void reload(RawFile const& file) {
+        m_texts.insert_or_assign(file.name, Text{ file.contents });
+    }
+
     [[nodiscard]] bool contains(c2k::Utf8StringView const key) const {
         return m_texts.contains(key);
     }
@@ -1,49 +1,72 @@
 #pragma once
 
 #include <iostream>
-#include <lib2k/utf8/string.hpp>
-#include <variant>
-#include "utils.hpp"
+#include <lib2k/types.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
 
-namespace token {
-    struct Colon final {};
+enum class TokenType : u8 {
+    Colon,
+    Comma,
+    Linebreak,
+    Indent,
+    Dedent,
+    Identifier,
+    String,
+    EndOfInput,
+};
 
-    struct Comma final {};
+// Tokens don't own their lexemes. Instead, they refer to a byte range of the source, which has to
+// outlive them.
+struct Token final {
+    TokenType type;
+    u32 offset;
+    u32 length;
 
-    struct Linebreak final {};
+    [[nodiscard]] std::string_view lexeme(std::string_view const source) const {
+        return source.substr(offset, length);
+    }
+};
 
-    struct Indent final {};
-
-    struct Dedent final {};
-
-    struct EndOfInput final {};
-
-    struct Identifier final {
-        c2k::Utf8String lexeme;
-    };
-
-    struct String final {
-        c2k::Utf8String lexeme;
-    };
-
-}  // namespace token
-
-using Token = std::
-    variant<token::Colon, token::Comma, token::Linebreak, token::Indent, token::Dedent, token::Identifier, token::String, token::EndOfInput>;
+inline std::ostream& operator<<(std::ostream& ostream, TokenType const type) {
+    switch (type) {
+        case TokenType::Colon:
+            return ostream << "COLON";
+        case TokenType::Comma:
+            return ostream << "COMMA";
+        case TokenType::Linebreak:
+            return ostream << "LINEBREAK";
+        case TokenType::Indent:
+            return ostream << "INDENT";
+        case TokenType::Dedent:
+            return ostream << "DEDENT";
+        case TokenType::Identifier:
+            return ostream << "IDENTIFIER";
+        case TokenType::String:
+            return ostream << "STRING";
+        case TokenType::EndOfInput:
+            return ostream << "END_OF_INPUT";
+    }
+    return ostream << "UNKNOWN";
+}
 
-inline std::ostream& operator<<(std::ostream& ostream, Token const& token) {
-    std::visit(
-        Overloaded{
-            [&](token::Colon const&) { ostream << "COLON"; },
-            [&](token::Comma const&) { ostream << "COMMA"; },
-            [&](token::Linebreak const&) { ostream << "LINEBREAK"; },
-            [&](token::Indent const&) { ostream << "INDENT"; },
-            [&](token::Dedent const&) { ostream << "DEDENT"; },
-            [&](token::EndOfInput const&) { ostream << "END_OF_INPUT"; },
-            [&](token::Identifier const& identifier) { ostream << "IDENTIFIER(" << identifier.lexeme.view() << ')'; },
-            [&](token::String const& identifier) { ostream << "STRING(" << identifier.lexeme.view() << ')'; },
-        },
-        token
-    );
-    return ostream;
+[[nodiscard]] inline std::string describe(Token const& token, std::string_view const source) {
+    auto result = std::string{};
+    switch (token.type) {
+        case TokenType::Identifier:
+            result += "IDENTIFIER(";
+            break;
+        case TokenType::String:
+            result += "STRING(";
+            break;
+        default: {
+            auto stream = std::ostringstream{};
+            stream << token.type;
+            return std::move(stream).str();
+        }
+    }
+    result += token.lexeme(source);
+    result += ')';
+    return result;
 }
@@ -6,12 +6,22 @@
 #include <lib2k/utf8/string.hpp>
 #include <lib2k/utf8/string_view.hpp>
 #include <sstream>
+#include <string_view>
 
 template<typename... Ts>
 struct Overloaded : Ts... {
     using Ts::operator()...;
 };
 
+// Allows looking up `std::string` keys of unordered containers by `std::string_view` without allocating.
+struct StringHash final {
+    using is_transparent = void;
+
+    [[nodiscard]] usize operator()(std::string_view const text) const noexcept {
+        return std::hash<std::string_view>{}(text);
+    }
+};
+
 template<typename T>
 [[nodiscard]] c2k::Utf8String to_string(T const& value) {
     auto stream = std::ostringstream{};
@@ -45,6 +55,10 @@ template<typename T>
     return c == ' ' or c == '\f' or c == '\n' or c == '\r' or c == '\t' or c == '\v';
 }
 
+[[nodiscard]] inline bool is_whitespace(char const c) {
+    return c == ' ' or c == '\f' or c == '\n' or c == '\r' or c == '\t' or c == '\v';
+}
+
 [[nodiscard]] inline c2k::Utf8StringView left_trim(c2k::Utf8StringView const view) {
     for (auto it = view.cbegin(); it != view.cend(); ++it) {
         if (not is_whitespace(*it)) {
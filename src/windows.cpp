@@ -66,6 +66,14 @@ static void set_cmd_to_utf8() {
     }
 }
 
+[[nodiscard]] std::optional<ConsoleSize> console_size() {
+    auto info = CONSOLE_SCREEN_BUFFER_INFO{};
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info) == 0) {
+        return std::nullopt;
+    }
+    return ConsoleSize{ info.srWindow.Right - info.srWindow.Left + 1, info.srWindow.Bottom - info.srWindow.Top + 1 };
+}
+
 void setup_terminal() {
     std::setlocale(LC_ALL, ".65001");
     enable_ansi();
@@ -2,6 +2,14 @@
 
 #ifdef _WIN32
 
+#include <optional>
+
+struct ConsoleSize final {
+    int width;
+    int height;
+};
+
 void setup_terminal();
+[[nodiscard]] std::optional<ConsoleSize> console_size();
 
 #endif
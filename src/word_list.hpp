@@ -6,11 +6,17 @@
 
 using WordList = std::vector<c2k::Utf8String>;
 
-[[nodiscard]] inline WordList read_word_list(std::filesystem::path const& path) {
-    auto const contents = c2k::Utf8String{ read_file(path) };
+[[nodiscard]] inline WordList read_word_list(c2k::Utf8String const& contents) {
     auto words = contents.split("\n");
     for (auto& word : words) {
         word = trim(word);
     }
     return words;
 }
+
+// Like `read_word_list()`, but also drops empty lines.
+[[nodiscard]] inline WordList read_synonyms(c2k::Utf8String const& contents) {
+    auto words = read_word_list(contents);
+    erase_if(words, [](auto const& word) { return word.is_empty(); });
+    return words;
+}
@@ -0,0 +1,135 @@
+#include "word_tables.hpp"
+#include <algorithm>
+#include <concepts>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include "builtin_words.hpp"
+#include "perfect_hash.hpp"
+#include "word_list.hpp"
+
+// Escapes every byte that isn't printable ASCII, so that the generated source doesn't depend on the
+// source character set of the compiler.
+[[nodiscard]] static std::string string_literal(std::string_view const text) {
+    auto stream = std::ostringstream{};
+    stream << '"';
+    for (auto const c : text) {
+        if (c == '"' or c == '\\') {
+            stream << '\\' << c;
+        } else if (c >= ' ' and c <= '~') {
+            stream << c;
+        } else {
+            // Octal escapes have at most three digits, so they can't swallow the following characters.
+            auto const byte = static_cast<u8>(c);
+            stream << '\\' << static_cast<char>('0' + (byte >> 6)) << static_cast<char>('0' + ((byte >> 3) & 7))
+                   << static_cast<char>('0' + (byte & 7));
+        }
+    }
+    stream << '"';
+    return std::move(stream).str();
+}
+
+template<typename Value>
+static void write_table(
+    std::ostream& stream,
+    std::string_view const name,
+    std::string_view const value_type,
+    std::vector<std::pair<std::string_view, Value>> const& entries
+) {
+    auto keys = std::vector<std::string_view>{};
+    for (auto const& [key, value] : entries) {
+        keys.push_back(key);
+    }
+    auto const layout = perfect_hash::build(keys);
+
+    stream << "    inline constexpr auto " << name << " = perfect_hash::Table<" << value_type << ", " << entries.size()
+           << ">{\n        {";
+    for (auto const seed : layout.seeds) {
+        stream << ' ' << seed << ',';
+    }
+    stream << " },\n        { {\n";
+    for (auto const slot : layout.slots) {
+        auto const& [key, value] = entries.at(slot);
+        stream << "            { " << string_literal(key) << ", ";
+        if constexpr (std::same_as<Value, bool>) {
+            stream << (value ? "true" : "false");
+        } else {
+            stream << "0x" << std::hex << value << std::dec;
+        }
+        stream << " },\n";
+    }
+    stream << "        } },\n    };\n";
+}
+
+namespace word_tables {
+    void generate(Content const& content, std::filesystem::path const& path) {
+        auto synonym_lists = std::vector<RawFile const*>{};
+        for (auto const& list : content.synonyms) {
+            synonym_lists.push_back(&list);
+        }
+        std::sort(synonym_lists.begin(), synonym_lists.end(), [](auto const lhs, auto const rhs) {
+            return lhs->name.view() < rhs->name.view();
+        });
+        if (synonym_lists.size() > 64) {
+            throw std::runtime_error{ "Too many synonym lists." };
+        }
+
+        // Every word of the synonym lists maps to the mask of the lists that contain it.
+        auto synonym_words = std::vector<WordList>{};
+        for (auto const list : synonym_lists) {
+            synonym_words.push_back(read_synonyms(list->contents));
+        }
+        auto synonyms = std::vector<std::pair<std::string_view, u64>>{};
+        auto synonym_indices = std::unordered_map<std::string_view, usize>{};
+        for (auto i = usize{ 0 }; i < synonym_words.size(); ++i) {
+            for (auto const& word : synonym_words.at(i)) {
+                auto const [iterator, inserted] = synonym_indices.try_emplace(word.view(), synonyms.size());
+                if (inserted) {
+                    synonyms.emplace_back(word.view(), 0);
+                }
+                synonyms.at(iterator->second).second |= u64{ 1 } << i;
+            }
+        }
+
+        auto const& ignore_list = content.list("ignore");
+        auto const ignore_words = read_word_list(ignore_list.contents);
+        auto ignored = std::vector<std::pair<std::string_view, bool>>{};
+        auto ignored_indices = std::unordered_set<std::string_view>{};
+        for (auto const& word : ignore_words) {
+            if (ignored_indices.insert(word.view()).second) {
+                ignored.emplace_back(word.view(), true);
+            }
+        }
+
+        auto stream = std::ostringstream{};
+        stream << "// Generated from the synonym lists and the ignore list by `main generate-word-tables`.\n"
+                  "#pragma once\n"
+                  "\n"
+                  "#include <array>\n"
+                  "#include <string_view>\n"
+                  "#include \"builtin_words.hpp\"\n"
+                  "#include \"perfect_hash.hpp\"\n"
+                  "\n"
+                  "namespace builtin_words::generated {\n";
+        stream << "    inline constexpr auto synonym_lists = std::array<List, " << synonym_lists.size() << ">{ {\n";
+        for (auto const list : synonym_lists) {
+            stream << "        { " << string_literal(list->name.view()) << ", 0x" << std::hex
+                   << builtin_words::content_hash(list->contents.view()) << std::dec << " },\n";
+        }
+        stream << "    } };\n\n";
+        stream << "    inline constexpr auto ignore_list_hash = u64{ 0x" << std::hex
+               << builtin_words::content_hash(ignore_list.contents.view()) << std::dec << " };\n\n";
+        write_table(stream, "synonym_table", "u64", synonyms);
+        stream << '\n';
+        write_table(stream, "ignore_table", "bool", ignored);
+        stream << "}  // namespace builtin_words::generated\n";
+
+        auto file = std::ofstream{ path, std::ios::binary };
+        file << std::move(stream).str();
+        if (not file) {
+            throw std::runtime_error{ "Unable to write " + path.string() };
+        }
+    }
+}  // namespace word_tables
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <filesystem>
+#include "content.hpp"
+
+// Generates the lookup tables of `builtin_words` from the synonym lists and the ignore list of the
+// content. The result is a C++ header, which is compiled into the game at build time.
+namespace word_tables {
+    void generate(Content const& content, std::filesystem::path const& path);
+}  // namespace word_tables
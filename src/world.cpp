@@ -1,106 +1,103 @@
 #include "world.hpp"
-#include <filesystem>
+#include <algorithm>
 #include <functional>
+#include <string_view>
+#include <utility>
 #include "action.hpp"
 #include "context.hpp"
 #include "dialog_database.hpp"
 #include "parser.hpp"
 #include "synonyms_dict.hpp"
 
-static constexpr auto items_directory = "items";
-static constexpr auto rooms_directory = "rooms";
-
-using DirectoryIterator = std::filesystem::recursive_directory_iterator;
-
-[[nodiscard]] static std::vector<std::unique_ptr<Action>> action_list(Tree const& tree) {
-    auto actions = std::vector<std::unique_ptr<Action>>{};
-    for (auto const& [action_type, arguments] : tree.entries()) {
+[[nodiscard]] static ActionList action_list(Tree const& tree) {
+    auto actions = ActionList{};
+    for (auto const& [action_type, arguments] : tree) {
         if (action_type == "print") {
-            if (not arguments->is_string()) {
+            if (not arguments.is_string()) {
                 throw std::runtime_error{ "Print action must have a string argument." };
             }
-            actions.push_back(std::make_unique<Print>(arguments->as_string().value()));
+            actions.emit(Opcode::Print, arguments.as_string());
             continue;
         }
         if (action_type == "with") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "Use action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<Use>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::With, intern_all(arguments.as_identifier_list()));
             continue;
         }
         if (action_type == "consume") {
-            if (arguments->is_reference()) {
-                actions.push_back(std::make_unique<Consume>());
+            if (arguments.is_reference()) {
+                actions.emit(Opcode::ConsumeSelf);
                 continue;
             }
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "Consume action must have a reference or an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<Consume>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::Consume, intern_all(arguments.as_identifier_list()));
             continue;
         }
         if (action_type == "spawn") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "Spawn action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<Spawn>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::Spawn, intern_all(arguments.as_identifier_list()));
             continue;
         }
         if (action_type == "take") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "Take action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<Take>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::Take, intern_all(arguments.as_identifier_list()));
             continue;
         }
         if (action_type == "define") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "Define action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<Define>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::Define, FlagSet::of(intern_all(arguments.as_identifier_list())));
             continue;
         }
         if (action_type == "undefine") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "Undefine action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<Undefine>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::Undefine, FlagSet::of(intern_all(arguments.as_identifier_list())));
             continue;
         }
         if (action_type == "if") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "If action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<If>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::If, FlagSet::of(intern_all(arguments.as_identifier_list())));
             continue;
         }
         if (action_type == "if_not") {
-            if (not arguments->is_identifier_list()) {
+            if (not arguments.is_identifier_list()) {
                 throw std::runtime_error{ "IfNot action must have an identifier list as argument." };
             }
-            actions.push_back(std::make_unique<IfNot>(arguments->as_identifier_list().values()));
+            actions.emit(Opcode::IfNot, FlagSet::of(intern_all(arguments.as_identifier_list())));
             continue;
         }
         if (action_type == "goto") {
-            if (not arguments->is_identifier_list() or arguments->as_identifier_list().values().size() != 1) {
-                throw std::runtime_error{ "IfNot action must have a single identifier as argument." };
+            if (not arguments.is_identifier_list() or arguments.as_identifier_list().size() != 1) {
+                throw std::runtime_error{ "Goto action must have a single identifier as argument." };
             }
-            actions.push_back(std::make_unique<Goto>(arguments->as_identifier_list().values().front()));
+            actions.emit(Opcode::Goto, intern_all(arguments.as_identifier_list()));
             continue;
         }
         if (action_type == "dialog") {
-            if (not arguments->is_identifier_list() or arguments->as_identifier_list().values().size() != 1) {
+            if (not arguments.is_identifier_list() or arguments.as_identifier_list().size() != 1) {
                 throw std::runtime_error{ "Dialog action must have a single identifier as argument." };
             }
-            actions.push_back(std::make_unique<DialogAction>(arguments->as_identifier_list().values().front()));
+            actions.emit(Opcode::Dialog, intern_all(arguments.as_identifier_list()));
             continue;
         }
         if (action_type == "win") {
-            if (not arguments->is_reference()) {
+            if (not arguments.is_reference()) {
                 throw std::runtime_error{ "Win action must have a reference as argument." };
             }
-            actions.push_back(std::make_unique<Win>());
+            actions.emit(Opcode::Win);
             continue;
         }
         throw std::runtime_error{ std::string{ action_type.view() } + " is not a valid action." };
@@ -108,55 +105,83 @@ using DirectoryIterator = std::filesystem::recursive_directory_iterator;
     return actions;
 }
 
-[[nodiscard]] static auto read_item_blueprints() {
-    auto blueprints = std::unordered_map<c2k::Utf8String, ItemBlueprint>{};
-    for (auto const& directory_entry : DirectoryIterator{ items_directory }) {
-        if (directory_entry.path().extension() != ".item") {
-            continue;
-        }
-        auto const tree = File{ directory_entry.path() }.tree();
-
-        auto actions = ItemBlueprint::Actions{};
+[[nodiscard]] static ItemBlueprint read_item_blueprint(ParsedFile const& file) {
+    auto const tree = file.document.root();
+    auto actions = ItemBlueprint::Actions{};
 
-        if (auto const actions_tree = tree.try_fetch<Tree>("actions")) {
-            for (auto const& [key, value] : actions_tree.value()) {
-                if (not value->is_tree()) {
-                    throw std::runtime_error{ "Actions must be defined as tree." };
-                }
-                actions.emplace_back(key, action_list(value->as_tree()));
+    if (auto const actions_tree = tree.try_fetch<Tree>("actions")) {
+        for (auto const& [key, value] : actions_tree.value()) {
+            if (not value.is_tree()) {
+                throw std::runtime_error{ "Actions must be defined as tree." };
             }
+            actions[Symbol{ key }].push_back(action_list(value.as_tree()));
         }
+    }
 
-        auto reference = c2k::Utf8String{ directory_entry.path().stem().string() };
-        auto item = ItemBlueprint{
-            reference,
-            tree.fetch<String>("name"),
-            tree.fetch<String>("description"),
-            tree.fetch<IdentifierList>("classes"),
-            std::move(actions),
-        };
-        blueprints.emplace(std::move(reference), std::move(item));
+    return ItemBlueprint{
+        Symbol{ file.name },
+        tree.fetch<String>("name"),
+        StyledText{ tree.fetch<String>("description") },
+        tree.fetch<IdentifierList>("classes").values(),
+        std::move(actions),
+    };
+}
+
+[[nodiscard]] static auto read_item_blueprints(std::vector<ParsedFile> const& files) {
+    auto blueprints = World::ItemBlueprints{};
+    for (auto const& file : files) {
+        blueprints.emplace(Symbol{ file.name }, read_item_blueprint(file));
     }
     return blueprints;
 }
 
+// The blueprints that items are instantiated from. While a reloaded blueprint is checked, it stands in for
+// the current version of the blueprint, so that the other blueprints don't have to be copied.
+class BlueprintLookup final {
+private:
+    World::ItemBlueprints const* m_blueprints;
+    tl::optional<Symbol> m_replaced;
+    ItemBlueprint const* m_replacement = nullptr;
+
+public:
+    explicit BlueprintLookup(World::ItemBlueprints const& blueprints)
+        : m_blueprints{ &blueprints } {}
+
+    BlueprintLookup(World::ItemBlueprints const& blueprints, Symbol const replaced, ItemBlueprint const& replacement)
+        : m_blueprints{ &blueprints }, m_replaced{ replaced }, m_replacement{ &replacement } {}
+
+    // Returns `nullptr` if there is no blueprint with the given name.
+    [[nodiscard]] ItemBlueprint const* find(Symbol const reference) const {
+        if (m_replaced.has_value() and m_replaced.value() == reference) {
+            return m_replacement;
+        }
+        auto const find_iterator = m_blueprints->find(reference);
+        return find_iterator == m_blueprints->cend() ? nullptr : &find_iterator->second;
+    }
+};
+
 [[nodiscard]] static std::unique_ptr<Item> instantiate_item(
-    World::ItemBlueprints const& blueprints,
+    BlueprintLookup const& blueprints,
     c2k::Utf8StringView const key,
-    Entry const& value
+    Entry const value
 ) {
-    auto const find_iterator = blueprints.find(key);
-    if (find_iterator == blueprints.cend()) {
+    auto const found = blueprints.find(Symbol{ key });
+    if (found == nullptr) {
         throw std::runtime_error{ "Item \"" + std::string{ key.view() } + "\" requested, but no blueprint found." };
     }
-    auto const& blueprint = find_iterator->second;
+    auto const& blueprint = *found;
     auto inventory = Inventory{};
     if (value.is_tree()) {
         // TODO: Apply other properties if present.
         auto const contents = value.as_tree().try_fetch<Tree>("contents");
         if (contents.has_value()) {
+            // The player could never get to items inside of something that can't be opened.
+            if (not blueprint.has_inventory()) {
+                throw std::runtime_error{ "Item \"" + std::string{ key.view() }
+                                          + "\" has contents, but no inventory." };
+            }
             for (auto const& [sub_key, sub_value] : contents.value()) {
-                inventory.insert(instantiate_item(blueprints, sub_key, *sub_value));
+                inventory.insert(instantiate_item(blueprints, sub_key, sub_value));
             }
         }
     } else if (not value.is_reference()) {
@@ -167,73 +192,168 @@ using DirectoryIterator = std::filesystem::recursive_directory_iterator;
     return std::make_unique<Item>(blueprint, std::move(inventory));
 }
 
-[[nodiscard]] static std::vector<Exit> extract_exits(World::ItemBlueprints const& item_blueprints, Tree const& tree) {
+// Whether the item is part of the contents of the room (or of the contents of its items).
+[[nodiscard]] static bool contains_item(Tree const& tree, c2k::Utf8StringView const item) {
+    auto const contents = tree.try_fetch<Tree>("contents");
+    if (not contents.has_value()) {
+        return false;
+    }
+    return std::ranges::any_of(contents.value(), [&](auto const& entry) {
+        auto const& [key, value] = entry;
+        return key == item or (value.is_tree() and contains_item(value.as_tree(), item));
+    });
+}
+
+[[nodiscard]] static std::vector<Exit> extract_exits(BlueprintLookup const& item_blueprints, Tree const& tree) {
     auto const exits_tree = tree.try_fetch<Tree>("exits");
     if (not exits_tree.has_value()) {
         return {};
     }
     auto exits = std::vector<Exit>{};
     for (auto const& [key, value] : exits_tree.value()) {
-        if (not value->is_tree()) {
-            throw std::runtime_error{ "Room exits must be defined as tree (got " + std::string{ value->type_name() }
-                                      + " " + std::string{ value->pretty_print(0, 0).view() } + ")." };
+        if (not value.is_tree()) {
+            throw std::runtime_error{ "Room exits must be defined as tree (got " + std::string{ value.type_name() }
+                                      + " " + std::string{ value.pretty_print(0, 0).view() } + ")." };
         }
-        auto const& sub_tree = value->as_tree();
+        auto const sub_tree = value.as_tree();
 
-        auto description = sub_tree.fetch<String>("description");
+        auto description = StyledText{ sub_tree.fetch<String>("description") };
 
         auto required_items = std::vector<ItemBlueprint const*>{};
-        auto on_locked = std::optional<c2k::Utf8String>{};
+        auto on_locked = std::optional<StyledText>{};
         if (auto const required_items_list = sub_tree.try_fetch<IdentifierList>("required_items")) {
             for (auto const& required_item : required_items_list.value()) {
-                auto const find_iterator = item_blueprints.find(required_item);
-                if (find_iterator == item_blueprints.cend()) {
+                auto const found = item_blueprints.find(Symbol{ required_item });
+                if (found == nullptr) {
                     throw std::runtime_error{ "Room exit requires item blueprint \""
                                               + std::string{ required_item.view() } + "\" which could not be found." };
                 }
-                required_items.push_back(&find_iterator->second);
+                required_items.push_back(found);
             }
-            on_locked = sub_tree.fetch<String>("on_locked");
+            on_locked.emplace(sub_tree.fetch<String>("on_locked"));
         }
 
-        exits.emplace_back(key, std::move(description), std::move(required_items), std::move(on_locked));
+        exits.emplace_back(Symbol{ key }, std::move(description), std::move(required_items), std::move(on_locked));
     }
     return exits;
 }
 
-[[nodiscard]] static auto read_rooms(World::ItemBlueprints const& item_blueprints) {
-    auto rooms = std::unordered_map<c2k::Utf8String, Room>{};
-    for (auto const& directory_entry : DirectoryIterator{ rooms_directory }) {
-        if (directory_entry.path().extension() != ".room") {
-            continue;
+[[nodiscard]] static std::unique_ptr<Room> read_room(BlueprintLookup const& item_blueprints, Tree const& tree) {
+    auto room = std::make_unique<Room>(
+        tree.fetch<String>("name"),
+        StyledText{ tree.fetch<String>("description") },
+        StyledText{ tree.fetch<String>("on_entry") },
+        StyledText{ tree.fetch<String>("on_exit") },
+        extract_exits(item_blueprints, tree)
+    );
+
+    // If the room has any contents, insert all items into the room's inventory.
+    if (auto const contents = tree.try_fetch<Tree>("contents")) {
+        for (auto const& [key, value] : contents.value()) {
+            room->insert(instantiate_item(item_blueprints, key, value));
         }
-        auto const tree = File{ directory_entry.path() }.tree();
-        auto room = Room{ tree.fetch<String>("name"),
-                          tree.fetch<String>("description"),
-                          tree.fetch<String>("on_entry"),
-                          tree.fetch<String>("on_exit"),
-                          extract_exits(item_blueprints, tree) };
-        auto [inserted, _] = rooms.emplace(directory_entry.path().stem().string(), std::move(room));
-
-        // If the room has any contents, insert all items into the room's inventory.
-        auto const contents = tree.try_fetch<Tree>("contents");
-        if (not contents.has_value()) {
+    }
+    return room;
+}
+
+World::World(Content const& content)
+    : m_item_blueprints{ read_item_blueprints(content.items) } {
+    for (auto const& [name, document] : content.rooms) {
+        m_rooms.try_emplace(Symbol{ name }, document);
+    }
+    if (auto const start_room = m_rooms.find(Symbol{ "start" }); start_room != m_rooms.cend()) {
+        m_current_room = &instantiate(start_room->second);
+        index_objects();
+        prefetch_neighbours(*m_current_room);
+    } else {
+        std::cerr << "Warning: No starting room found. Please add a file called \"start.room\".\n";
+    }
+}
+
+void World::reload_item_blueprint(ParsedFile const& file, DialogDatabase const& dialog_database) {
+    auto const reference = Symbol{ file.name };
+    auto blueprint = read_item_blueprint(file);
+    check_references(blueprint, dialog_database);
+
+    // The rooms that contain the item are read again with the new version, so that an edit that breaks
+    // them is rejected now instead of when the room is entered.
+    auto const blueprints = BlueprintLookup{ m_item_blueprints, reference, blueprint };
+    for (auto const& [room_reference, lazy_room] : m_rooms) {
+        if (not contains_item(lazy_room.document.root(), file.name)) {
             continue;
         }
-        for (auto const& [key, value] : contents.value()) {
-            inserted->second.insert(instantiate_item(item_blueprints, key, *value));
+        try {
+            std::ignore = read_room(blueprints, lazy_room.document.root());
+        } catch (std::exception const& exception) {
+            throw std::runtime_error{ "Room \"" + std::string{ room_reference.name().view() }
+                                      + "\" would become invalid: " + exception.what() };
         }
     }
 
-    return rooms;
+    m_prefetcher = {};
+    // Assigning to an existing blueprint keeps its address, so all items and exits that point to it
+    // stay valid and pick up the changes.
+    m_item_blueprints.insert_or_assign(reference, std::move(blueprint));
+    if (m_current_room != nullptr) {
+        index_objects();
+    }
 }
 
-World::World()
-    : m_item_blueprints{ read_item_blueprints() }, m_rooms{ read_rooms(m_item_blueprints) } {
-    if (auto const start_room = m_rooms.find("start"); start_room != m_rooms.cend()) {
-        m_current_room = &start_room->second;
-    } else {
-        std::cerr << "Warning: No starting room found. Please add a file called \"start.room\".\n";
+void World::reload_room(ParsedFile const& file) {
+    m_prefetcher = {};
+    auto const reference = Symbol{ file.name };
+    auto room = read_room(BlueprintLookup{ m_item_blueprints }, file.document.root());
+    for (auto const& exit : room->exits()) {
+        if (not m_rooms.contains(exit.target_room) and exit.target_room != reference) {
+            std::cerr << "Warning: Room \"" << file.name.view() << "\" has an exit to unknown room \""
+                      << exit.target_room.name().view() << "\".\n";
+        }
+    }
+
+    auto& lazy_room = m_rooms.try_emplace(reference, file.document).first->second;
+    lazy_room.document = file.document;
+    lazy_room.update_folded_name();
+    std::call_once(lazy_room.instantiated, [&] { lazy_room.room = std::move(room); });
+    if (room != nullptr) {
+        // The room has been instantiated before. Assigning to it keeps its address, so that the
+        // current room stays valid. Its contents are reset to the ones defined in the file.
+        *lazy_room.room = std::move(*room);
+    }
+    if (m_current_room == nullptr and file.name == "start") {
+        m_current_room = lazy_room.room.get();
+    }
+    if (m_current_room != nullptr) {
+        index_objects();
+    }
+}
+
+void World::check_references(ItemBlueprint const& blueprint, DialogDatabase const& dialog_database) const {
+    for (auto const& [category, alternatives] : blueprint.actions()) {
+        for (auto const& actions : alternatives) {
+            actions.for_each_symbol([&](Opcode const opcode, Symbol const symbol) {
+                auto const [kind, known] = [&]() -> std::pair<std::string_view, bool> {
+                    switch (opcode) {
+                        case Opcode::Goto:
+                            return { "room", m_rooms.contains(symbol) };
+                        case Opcode::Dialog:
+                            return { "dialog", dialog_database.contains(symbol) };
+                        default:
+                            return { "item", m_item_blueprints.contains(symbol) or symbol == blueprint.reference() };
+                    }
+                }();
+                if (not known) {
+                    throw std::runtime_error{ "Action \"" + std::string{ category.name().view() }
+                                              + "\" refers to unknown " + std::string{ kind } + " \""
+                                              + std::string{ symbol.name().view() } + "\"." };
+                }
+            });
+        }
+    }
+}
+
+void World::instantiate_all_rooms() const {
+    for (auto const& [name, lazy_room] : m_rooms) {
+        std::ignore = instantiate(lazy_room);
     }
 }
 
@@ -263,18 +383,19 @@ World::World()
         // Check if there's an item that provides a custom action for the
         // given nouns.
         auto const context = build_context(terminal, text_database, dialog_database);
-        auto const category = synonyms.reverse_lookup(command.verb);
+        // Categories that aren't interned can't have any actions.
+        auto const category = synonyms.find_category(command.verb);
 
-        if (auto item = find_item(command.nouns.at(0).noun, true)) {
+        if (auto item = category ? find_item(command.nouns.at(0).noun, true) : tl::nullopt) {
             // "item" now is the item that the player wants to interact with.
             if (auto target = find_item(command.nouns.at(1).noun, true)) {
                 // "target" now is the target item that the player wants to interact with.
-                if (item.value()->try_execute_action(category, { target.value().get() }, context)) {
+                if (item.value()->try_execute_action(category.value(), { target.value().get() }, context)) {
                     return m_running;
                 }
 
                 // If this didn't work, we try to swap the items.
-                if (target.value()->try_execute_action(category, { item.value().get() }, context)) {
+                if (target.value()->try_execute_action(category.value(), { item.value().get() }, context)) {
                     return m_running;
                 }
             }
@@ -288,7 +409,7 @@ World::World()
     auto objects = WordList{};
     objects.push_back(m_current_room->name());
     for (auto const& exit : m_current_room->exits()) {
-        objects.push_back(m_rooms.at(exit.target_room).name());
+        objects.push_back(instantiate(m_rooms.at(exit.target_room)).name());
     }
     for (auto const& item : m_current_room->inventory()) {
         objects.push_back(item->blueprint().name());
@@ -347,9 +468,9 @@ World::World()
     // First, we check if there's an item that provides a custom action for the
     // given noun. If so, we execute the action and return early.
     auto const context = build_context(terminal, text_database, dialog_database);
-    auto const category = synonyms.reverse_lookup(verb);
-    if (auto item = find_item(noun, true)) {
-        if (item.value()->try_execute_action(category, {}, context)) {
+    auto const category = synonyms.find_category(verb);
+    if (auto item = category ? find_item(noun, true) : tl::nullopt) {
+        if (item.value()->try_execute_action(category.value(), {}, context)) {
             return true;
         }
     }
@@ -373,7 +494,7 @@ World::World()
     }
     if (synonyms.is_synonym_of(verb, "look")) {
         // Check if the noun is the name of the current room.
-        if (noun == m_current_room->name().to_lowercase()) {
+        if (noun == m_current_room->folded_name()) {
             terminal.println(m_current_room->description());
             return true;
         }
@@ -388,9 +509,7 @@ World::World()
         if (auto const item = std::find_if(
                 m_inventory.begin(),
                 m_inventory.end(),
-                [&](auto const& item) {
-                    return item->blueprint().name().to_lowercase() == c2k::Utf8String{ noun }.to_lowercase();
-                }
+                [&](auto const& item) { return item->blueprint().folded_name() == noun; }
             );
             item != m_inventory.end()) {
             terminal.println((*item)->blueprint().description());
@@ -412,11 +531,7 @@ World::World()
                     return true;
                 }
             }
-            auto& target_room = find_room_by_reference(exit.value().target_room);
-            terminal.clear(true);
-            terminal.println(m_current_room->on_exit());
-            m_current_room = &target_room;
-            terminal.println(m_current_room->on_entry());
+            enter(find_room_by_reference(exit.value().target_room), terminal);
             return true;
         }
         return false;
@@ -435,6 +550,7 @@ World::World()
             terminal.println("Du findest die folgenden Gegenstände:");
             for (auto& item_to_take : inventory) {
                 terminal.println(item_to_take->blueprint().name());
+                m_objects.insert(item_to_take->blueprint().folded_name());
                 m_current_room->insert(std::move(item_to_take));
             }
             inventory.clear();
@@ -445,18 +561,78 @@ World::World()
     return false;
 }
 
-[[nodiscard]] Room& World::find_room_by_reference(c2k::Utf8StringView const name) {
-    auto const find_iterator = m_rooms.find(name);
+// Rooms can be instantiated concurrently by the prefetcher, which only ever reads the item blueprints.
+[[nodiscard]] Room& World::instantiate(LazyRoom const& lazy_room) const {
+    std::call_once(lazy_room.instantiated, [&] {
+        lazy_room.room = read_room(BlueprintLookup{ m_item_blueprints }, lazy_room.document.root());
+    });
+    return *lazy_room.room;
+}
+
+void World::enter(Room& room, Terminal& terminal) {
+    terminal.clear(true);
+    terminal.println(m_current_room->on_exit());
+    m_current_room = &room;
+    index_objects();
+    terminal.println(m_current_room->on_entry());
+    prefetch_neighbours(room);
+}
+
+// Rebuilds the object index for the current room. Exits are indexed by the names of their target
+// rooms as read from their documents, so that the target rooms don't have to be instantiated.
+void World::index_objects() {
+    m_objects.clear();
+    m_objects.insert(m_current_room->folded_name());
+    for (auto const& exit : m_current_room->exits()) {
+        if (auto const find_iterator = m_rooms.find(exit.target_room); find_iterator != m_rooms.cend()) {
+            m_objects.insert(find_iterator->second.folded_name);
+        }
+    }
+    for (auto const& item : m_current_room->inventory()) {
+        m_objects.insert(item->blueprint().folded_name());
+    }
+    for (auto const& item : m_inventory) {
+        m_objects.insert(item->blueprint().folded_name());
+    }
+}
+
+// Instantiates the rooms reachable from the given room in the background, so that entering them
+// doesn't have to wait for their contents to be instantiated.
+void World::prefetch_neighbours(Room const& room) {
+    auto neighbours = std::vector<LazyRoom const*>{};
+    for (auto const& exit : room.exits()) {
+        if (auto const find_iterator = m_rooms.find(exit.target_room); find_iterator != m_rooms.cend()) {
+            neighbours.push_back(&find_iterator->second);
+        }
+    }
+    // Assigning a new thread stops and joins the previous one.
+    m_prefetcher = std::jthread{ [this, neighbours = std::move(neighbours)](std::stop_token const& stop_token) {
+        for (auto const neighbour : neighbours) {
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            try {
+                std::ignore = instantiate(*neighbour);
+            } catch (...) {
+                // The error will be reported when the room is actually needed, since `std::call_once`
+                // doesn't consider a call that throws as completed.
+            }
+        }
+    } };
+}
+
+[[nodiscard]] Room& World::find_room_by_reference(Symbol const reference) {
+    auto const find_iterator = m_rooms.find(reference);
     if (find_iterator == m_rooms.end()) {
-        throw std::runtime_error{ "Room '" + std::string{ name.view() } + "' not found." };
+        throw std::runtime_error{ "Room '" + std::string{ reference.name().view() } + "' not found." };
     }
-    return find_iterator->second;
+    return instantiate(find_iterator->second);
 }
 
-[[nodiscard]] tl::optional<Exit const&> World::find_exit(c2k::Utf8StringView const name) {
+[[nodiscard]] tl::optional<Exit const&> World::find_exit(c2k::Utf8StringView const folded_name) {
     for (auto const& exit : m_current_room->exits()) {
-        auto const& room = find_room_by_reference(exit.target_room);
-        if (room.name().to_lowercase() == c2k::Utf8String{ name }.to_lowercase()) {
+        auto const find_iterator = m_rooms.find(exit.target_room);
+        if (find_iterator != m_rooms.cend() and find_iterator->second.folded_name == folded_name) {
             return exit;
         }
     }
@@ -464,12 +640,12 @@ World::World()
 }
 
 [[nodiscard]] tl::optional<std::unique_ptr<Item>&> World::find_item(
-    c2k::Utf8StringView const name,
+    c2k::Utf8StringView const folded_name,
     bool include_player_inventory
 ) {
     auto& inventory = m_current_room->inventory();
     auto find_iterator = std::find_if(inventory.begin(), inventory.end(), [&](auto& item) {
-        return item->blueprint().name().to_lowercase() == c2k::Utf8String{ name }.to_lowercase();
+        return item->blueprint().folded_name() == folded_name;
     });
     if (find_iterator != inventory.end()) {
         return *find_iterator;
@@ -480,7 +656,7 @@ World::World()
     }
 
     find_iterator = std::find_if(m_inventory.begin(), m_inventory.end(), [&](auto& item) {
-        return item->blueprint().name().to_lowercase() == c2k::Utf8String{ name }.to_lowercase();
+        return item->blueprint().folded_name() == folded_name;
     });
     if (find_iterator != m_inventory.end()) {
         return *find_iterator;
@@ -493,68 +669,36 @@ World::World()
     TextDatabase const& text_database,
     DialogDatabase const& dialog_database
 ) {
-    auto available_items = std::vector<Item*>{};
-    for (auto& item : m_current_room->inventory()) {
-        available_items.push_back(item.get());
-    }
-    for (auto& item : m_inventory) {
-        available_items.push_back(item.get());
-    }
-
-    auto const define = [this](c2k::Utf8StringView const identifier) {
-        m_defines.insert(identifier);
-    };
-
-    auto const has_item = [this](c2k::Utf8StringView const reference) -> bool {
-        return std::find_if(
-                   m_inventory.cbegin(),
-                   m_inventory.cend(),
-                   [&](auto const& item) { return item->blueprint().reference() == reference; }
-               )
-               != m_inventory.cend();
-    };
+    return Context{ *this, terminal, text_database, dialog_database };
+}
 
-    return Context{
-        terminal,
-        std::move(available_items),
-        [this](Item* item) { remove_item(item); },
-        [this](c2k::Utf8StringView const reference, SpawnLocation const location) { spawn_item(reference, location); },
-        define,
-        [this](c2k::Utf8StringView const identifier) { m_defines.erase(identifier); },
-        [this](c2k::Utf8StringView const identifier) { return m_defines.contains(identifier); },
-        [this, &terminal](c2k::Utf8StringView const room_reference) {
-            auto& room = find_room_by_reference(room_reference);
-            terminal.clear(true);
-            terminal.println(m_current_room->on_exit());
-            m_current_room = &room;
-            terminal.println(m_current_room->on_entry());
-        },
-        [this, &terminal, &dialog_database, define, has_item](c2k::Utf8StringView const dialog_reference) {
-            dialog_database.run_dialog(dialog_reference, terminal, define, has_item);
-        },
-        [this, &terminal, &text_database] {
-            terminal.clear(true);
-            text_database.get("win").print(terminal);
-            m_running = false;
-        },
-    };
+[[nodiscard]] bool World::has_item(Symbol const reference) const {
+    return std::find_if(
+               m_inventory.cbegin(),
+               m_inventory.cend(),
+               [&](auto const& item) { return item->blueprint().reference() == reference; }
+           )
+           != m_inventory.cend();
 }
 
 void World::remove_item(Item* item) {
-    if (m_inventory.remove(item)) {
-        return;
-    }
-    if (m_current_room->inventory().remove(item)) {
-        return;
+    if (item != nullptr) {
+        // Removing the item destroys it, but its blueprint outlives it.
+        auto const& blueprint = item->blueprint();
+        if (m_inventory.remove(item) or m_current_room->inventory().remove(item)) {
+            m_objects.erase(blueprint.folded_name());
+            return;
+        }
     }
     throw std::runtime_error{ "Item to remove could not be found." };
 }
 
-void World::spawn_item(c2k::Utf8StringView const reference, SpawnLocation const location) {
+void World::spawn_item(Symbol const reference, SpawnLocation const location) {
     auto const item_blueprint = m_item_blueprints.find(reference);
     if (item_blueprint == m_item_blueprints.cend()) {
-        throw std::runtime_error{ "Item blueprint \"" + std::string{ reference.view() } + "\" not found." };
+        throw std::runtime_error{ "Item blueprint \"" + std::string{ reference.name().view() } + "\" not found." };
     }
+    m_objects.insert(item_blueprint->second.folded_name());
     switch (location) {
         case SpawnLocation::Inventory:
             m_inventory.insert(item_blueprint->second.instantiate());
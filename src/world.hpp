@@ -1,11 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
-#include <unordered_set>
 #include "command.hpp"
+#include "content.hpp"
 #include "dialog_database.hpp"
+#include "flag_set.hpp"
 #include "item.hpp"
+#include "object_index.hpp"
 #include "room.hpp"
+#include "symbol.hpp"
 #include "synonyms_dict.hpp"
 #include "terminal.hpp"
 #include "text_database.hpp"
@@ -14,19 +20,56 @@
 class Context;
 
 class World final {
+    friend class Context;
+
 public:
-    using ItemBlueprints = std::unordered_map<c2k::Utf8String, ItemBlueprint>;
+    using ItemBlueprints = std::unordered_map<Symbol, ItemBlueprint>;
 
 private:
+    // Rooms are only instantiated from their documents when they are needed for the first time.
+    struct LazyRoom final {
+        Document document;
+        c2k::Utf8String folded_name;  // Read from the document, so that exits can be named without instantiating.
+        mutable std::once_flag instantiated;
+        mutable std::unique_ptr<Room> room;
+
+        explicit LazyRoom(Document document)
+            : document{ std::move(document) } {
+            update_folded_name();
+        }
+
+        void update_folded_name() {
+            folded_name = document.root().try_fetch<String>("name").map([](auto const& name) {
+                return c2k::Utf8String{ name }.to_lowercase();
+            }).value_or(c2k::Utf8String{});
+        }
+    };
+
     ItemBlueprints m_item_blueprints;
-    std::unordered_map<c2k::Utf8String, Room> m_rooms;
+    std::unordered_map<Symbol, LazyRoom> m_rooms;
     Room* m_current_room = nullptr;
     Inventory m_inventory;
-    std::unordered_set<c2k::Utf8String> m_defines;
+    FlagSet m_flags;
+    ObjectIndex m_objects;
     bool m_running = true;
+    std::jthread m_prefetcher;  // Declared last, so it's stopped before the rooms are destroyed.
 
 public:
-    World();
+    explicit World(Content const& content);
+
+    // The prefetcher refers to the world, so it must not be moved.
+    World(World&&) = delete;
+    World& operator=(World&&) = delete;
+
+    // Replace (or add) a single item blueprint or room with a new version of its file. If the new
+    // version is invalid, an exception is thrown and the old version is kept. A blueprint is also
+    // invalid if its actions refer to unknown content, or if it breaks a room that contains the item.
+    void reload_item_blueprint(ParsedFile const& file, DialogDatabase const& dialog_database);
+    void reload_room(ParsedFile const& file);
+
+    // Instantiates all rooms that have not been needed so far, which reports all errors in their
+    // definitions.
+    void instantiate_all_rooms() const;
     [[nodiscard]] bool process_command(
         Command const& command,
         Terminal& terminal,
@@ -36,6 +79,11 @@ public:
     );
     [[nodiscard]] WordList known_objects() const;
 
+    // The objects the player can refer to in the current room.
+    [[nodiscard]] ObjectIndex const& objects() const {
+        return m_objects;
+    }
+
 private:
     [[nodiscard]] bool try_handle_single_verb(
         c2k::Utf8StringView verb,
@@ -52,10 +100,16 @@ private:
         TextDatabase const& text_database,
         DialogDatabase const& dialog_database
     );
-    [[nodiscard]] Room& find_room_by_reference(c2k::Utf8StringView name);
-    [[nodiscard]] tl::optional<Exit const&> find_exit(c2k::Utf8StringView name);
+    void check_references(ItemBlueprint const& blueprint, DialogDatabase const& dialog_database) const;
+    [[nodiscard]] Room& instantiate(LazyRoom const& lazy_room) const;
+    void enter(Room& room, Terminal& terminal);
+    void index_objects();
+    void prefetch_neighbours(Room const& room);
+    [[nodiscard]] Room& find_room_by_reference(Symbol reference);
+    // The names must be case-folded, like the nouns of parsed commands.
+    [[nodiscard]] tl::optional<Exit const&> find_exit(c2k::Utf8StringView folded_name);
     [[nodiscard]] tl::optional<std::unique_ptr<Item>&> find_item(
-        c2k::Utf8StringView name,
+        c2k::Utf8StringView folded_name,
         bool include_player_inventory = false
     );
     [[nodiscard]] Context build_context(
@@ -63,6 +117,7 @@ private:
         TextDatabase const& text_database,
         DialogDatabase const& dialog_database
     );
+    [[nodiscard]] bool has_item(Symbol reference) const;
     void remove_item(Item* item);
-    void spawn_item(c2k::Utf8StringView reference, SpawnLocation location);
+    void spawn_item(Symbol reference, SpawnLocation location);
 };
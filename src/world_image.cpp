@@ -0,0 +1,447 @@
+#include "world_image.hpp"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "mapped_file.hpp"
+
+// Image layout (native byte order, every section aligned to 8 bytes):
+//
+//     Header | SourceRecord[] | DocumentRecord[] | NodeRecord[] | StringRef[] | RawFileRecord[] | string pool
+//
+// The nodes of all documents share one table. The children of a tree node are stored contiguously
+// and always after their parent, so every document can be walked front to back.
+
+static constexpr auto magic = std::array{ 'G', 'W', 'W', 'O', 'R', 'L', 'D', '\0' };
+static constexpr auto version = u32{ 1 };
+static constexpr auto byte_order_mark = u32{ 0x01020304 };
+static constexpr auto section_alignment = usize{ 8 };
+
+struct StringRef final {
+    u32 offset;
+    u32 length;
+};
+
+struct Section final {
+    u64 offset;
+    u64 count;
+};
+
+struct Header final {
+    std::array<char, 8> magic;
+    u32 version;
+    u32 byte_order_mark;
+    Section sources;
+    Section documents;
+    Section nodes;
+    Section identifiers;
+    Section raw_files;
+    Section strings;
+};
+
+enum class NodeKind : u32 {
+    Tree,
+    String,
+    IdentifierList,
+    Reference,
+};
+
+struct SourceRecord final {
+    StringRef path;
+    ContentKind kind;
+    u32 padding;
+    u64 size;
+    i64 modification_time;
+};
+
+struct DocumentRecord final {
+    ContentKind kind;
+    StringRef name;
+    u32 root;
+};
+
+// Trees: `first` and `count` describe the range of child nodes.
+// Strings: `first` and `count` are the offset and length of the value within the string pool.
+// Identifier lists: `first` and `count` describe the range within the identifier table.
+struct NodeRecord final {
+    NodeKind kind;
+    StringRef key;
+    u32 first;
+    u32 count;
+};
+
+struct RawFileRecord final {
+    ContentKind kind;
+    StringRef name;
+    StringRef contents;
+};
+
+struct SourceStamp final {
+    u64 size;
+    i64 modification_time;
+};
+
+[[nodiscard]] static SourceStamp stamp(std::filesystem::path const& path) {
+    return SourceStamp{
+        std::filesystem::file_size(path),
+        std::filesystem::last_write_time(path).time_since_epoch().count(),
+    };
+}
+
+[[nodiscard]] static u32 narrow(usize const value) {
+    if (value > std::numeric_limits<u32>::max()) {
+        throw std::runtime_error{ "Content too large to be stored in a world image." };
+    }
+    return static_cast<u32>(value);
+}
+
+class ImageWriter final {
+private:
+    std::vector<SourceRecord> m_sources;
+    std::vector<DocumentRecord> m_documents;
+    std::vector<NodeRecord> m_nodes;
+    std::vector<StringRef> m_identifiers;
+    std::vector<RawFileRecord> m_raw_files;
+    std::string m_strings;
+    std::unordered_map<std::string, u32> m_string_offsets;
+
+public:
+    void add_source(SourceFile const& source) {
+        auto const [size, modification_time] = stamp(source.path);
+        m_sources.push_back(
+            SourceRecord{ string(source.path.generic_string()), source.kind, 0, size, modification_time }
+        );
+    }
+
+    void add_document(ContentKind const kind, ParsedFile const& file) {
+        auto const root = narrow(m_nodes.size());
+        m_nodes.push_back(NodeRecord{ NodeKind::Tree, string(""), 0, 0 });
+        add_children(root, file.document.root());
+        m_documents.push_back(DocumentRecord{ kind, string(file.name.view()), root });
+    }
+
+    void add_raw_file(ContentKind const kind, RawFile const& file) {
+        m_raw_files.push_back(RawFileRecord{ kind, string(file.name.view()), string(file.contents.view()) });
+    }
+
+    [[nodiscard]] std::string finish() const {
+        auto image = std::string(sizeof(Header), '\0');
+        auto header = Header{};
+        header.magic = magic;
+        header.version = version;
+        header.byte_order_mark = byte_order_mark;
+        header.sources = append(image, std::span{ m_sources });
+        header.documents = append(image, std::span{ m_documents });
+        header.nodes = append(image, std::span{ m_nodes });
+        header.identifiers = append(image, std::span{ m_identifiers });
+        header.raw_files = append(image, std::span{ m_raw_files });
+        header.strings = append(image, std::span{ m_strings });
+        std::memcpy(image.data(), &header, sizeof(header));
+        return image;
+    }
+
+private:
+    [[nodiscard]] StringRef string(std::string_view const value) {
+        auto const [iterator, inserted] = m_string_offsets.try_emplace(std::string{ value }, 0);
+        if (inserted) {
+            iterator->second = narrow(m_strings.size());
+            m_strings += value;
+        }
+        return StringRef{ iterator->second, narrow(value.size()) };
+    }
+
+    void add_children(u32 const parent, Tree const tree) {
+        auto const first = narrow(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + tree.size());
+        m_nodes.at(parent).first = first;
+        m_nodes.at(parent).count = narrow(tree.size());
+
+        auto index = first;
+        for (auto const& [key, value] : tree) {
+            auto node = NodeRecord{ NodeKind::Reference, string(key.view()), 0, 0 };
+            if (value.is_string()) {
+                auto const [offset, length] = string(value.as_string().view());
+                node = NodeRecord{ NodeKind::String, node.key, offset, length };
+            } else if (value.is_identifier_list()) {
+                auto const identifiers = value.as_identifier_list();
+                node = NodeRecord{ NodeKind::IdentifierList,
+                                   node.key,
+                                   narrow(m_identifiers.size()),
+                                   narrow(identifiers.size()) };
+                for (auto const& identifier : identifiers) {
+                    m_identifiers.push_back(string(identifier.view()));
+                }
+            } else if (value.is_tree()) {
+                node.kind = NodeKind::Tree;
+            }
+            m_nodes.at(index) = node;
+            if (value.is_tree()) {
+                add_children(index, value.as_tree());
+            }
+            ++index;
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]] static Section append(std::string& image, std::span<T const> const records) {
+        image.resize((image.size() + section_alignment - 1) / section_alignment * section_alignment, '\0');
+        auto const offset = image.size();
+        image.append(reinterpret_cast<char const*>(records.data()), records.size_bytes());
+        return Section{ offset, records.size() };
+    }
+};
+
+// Checks that the image is a world image and returns its header. Only the magic, the byte order mark and
+// the version are valid for images of every version, so the version has to be checked before anything else
+// of the header is used.
+[[nodiscard]] static Header read_header(std::span<std::byte const> const image) {
+    if (image.size() < sizeof(Header)) {
+        throw std::runtime_error{ "File too small." };
+    }
+    auto header = Header{};
+    std::memcpy(&header, image.data(), sizeof(header));
+    if (header.magic != magic) {
+        throw std::runtime_error{ "Not a world image." };
+    }
+    if (header.byte_order_mark != byte_order_mark) {
+        throw std::runtime_error{ "Image was created on a machine with a different byte order." };
+    }
+    return header;
+}
+
+class ImageReader final {
+private:
+    std::span<std::byte const> m_image;
+    Header m_header;
+    std::span<NodeRecord const> m_nodes;
+    std::span<StringRef const> m_identifiers;
+    std::string_view m_strings;
+
+public:
+    // The header must have been read by `read_header()` and its version must be the current one.
+    ImageReader(std::span<std::byte const> const image, Header const& header)
+        : m_image{ image }, m_header{ header } {
+        m_nodes = section<NodeRecord>(m_header.nodes);
+        m_identifiers = section<StringRef>(m_header.identifiers);
+        auto const strings = section<char>(m_header.strings);
+        m_strings = std::string_view{ strings.data(), strings.size() };
+    }
+
+    [[nodiscard]] bool matches(std::vector<SourceFile> const& sources) const {
+        auto const records = section<SourceRecord>(m_header.sources);
+        if (records.size() != sources.size()) {
+            return false;
+        }
+        for (auto i = usize{ 0 }; i < sources.size(); ++i) {
+            auto const& record = records[i];
+            auto const& source = sources.at(i);
+            if (record.kind != source.kind or string(record.path) != source.path.generic_string()) {
+                return false;
+            }
+            auto const [size, modification_time] = stamp(source.path);
+            if (record.size != size or record.modification_time != modification_time) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] Content content() const {
+        auto content = Content{};
+        for (auto const& document : section<DocumentRecord>(m_header.documents)) {
+            auto file = ParsedFile{ utf8(document.name), parse_document(document.root) };
+            switch (document.kind) {
+                case ContentKind::Item:
+                    content.items.push_back(std::move(file));
+                    break;
+                case ContentKind::Room:
+                    content.rooms.push_back(std::move(file));
+                    break;
+                case ContentKind::Dialog:
+                    content.dialogs.push_back(std::move(file));
+                    break;
+                default:
+                    throw std::runtime_error{ "Invalid document kind." };
+            }
+        }
+        for (auto const& raw_file : section<RawFileRecord>(m_header.raw_files)) {
+            auto file = RawFile{ utf8(raw_file.name), utf8(raw_file.contents) };
+            switch (raw_file.kind) {
+                case ContentKind::Text:
+                    content.texts.push_back(std::move(file));
+                    break;
+                case ContentKind::Synonyms:
+                    content.synonyms.push_back(std::move(file));
+                    break;
+                case ContentKind::List:
+                    content.lists.push_back(std::move(file));
+                    break;
+                default:
+                    throw std::runtime_error{ "Invalid raw file kind." };
+            }
+        }
+        return content;
+    }
+
+private:
+    template<typename T>
+    [[nodiscard]] std::span<T const> section(Section const& section) const {
+        if (section.offset % alignof(T) != 0 or section.offset > m_image.size()
+            or section.count > (m_image.size() - section.offset) / sizeof(T)) {
+            throw std::runtime_error{ "Section out of bounds." };
+        }
+        return std::span{ reinterpret_cast<T const*>(m_image.data() + section.offset),
+                          static_cast<usize>(section.count) };
+    }
+
+    [[nodiscard]] std::string_view string(StringRef const& reference) const {
+        if (reference.offset > m_strings.size() or reference.length > m_strings.size() - reference.offset) {
+            throw std::runtime_error{ "String out of bounds." };
+        }
+        return m_strings.substr(reference.offset, reference.length);
+    }
+
+    [[nodiscard]] c2k::Utf8String utf8(StringRef const& reference) const {
+        return c2k::Utf8String{ std::string{ string(reference) } };
+    }
+
+    [[nodiscard]] NodeRecord const& node(u32 const index) const {
+        if (index >= m_nodes.size()) {
+            throw std::runtime_error{ "Node index out of bounds." };
+        }
+        return m_nodes[index];
+    }
+
+    [[nodiscard]] Document parse_document(u32 const root) const {
+        auto builder = DocumentBuilder{};
+        add_children(builder, root);
+        return std::move(builder).finish();
+    }
+
+    // The builder copies the strings out of the image when the document is finished, so it's fine
+    // to hand it views into the mapped string pool.
+    void add_children(DocumentBuilder& builder, u32 const index) const {
+        auto const& parent = node(index);
+        if (parent.kind != NodeKind::Tree or (parent.count > 0 and parent.first <= index)) {
+            throw std::runtime_error{ "Invalid tree node." };
+        }
+        if (parent.first > m_nodes.size() or parent.count > m_nodes.size() - parent.first) {
+            throw std::runtime_error{ "Child nodes out of bounds." };
+        }
+        for (auto i = u32{ 0 }; i < parent.count; ++i) {
+            auto const child_index = parent.first + i;
+            auto const& child = node(child_index);
+            auto const key = string(child.key);
+            switch (child.kind) {
+                case NodeKind::Tree: {
+                    auto const marker = builder.open_tree();
+                    add_children(builder, child_index);
+                    builder.close_tree(key, marker);
+                    break;
+                }
+                case NodeKind::String:
+                    builder.add_string(key, string(StringRef{ child.first, child.count }));
+                    break;
+                case NodeKind::IdentifierList: {
+                    if (child.first > m_identifiers.size() or child.count > m_identifiers.size() - child.first) {
+                        throw std::runtime_error{ "Identifier list out of bounds." };
+                    }
+                    auto identifiers = std::vector<std::string_view>{};
+                    identifiers.reserve(child.count);
+                    for (auto const& identifier : m_identifiers.subspan(child.first, child.count)) {
+                        identifiers.push_back(string(identifier));
+                    }
+                    builder.add_identifier_list(key, identifiers);
+                    break;
+                }
+                case NodeKind::Reference:
+                    builder.add_reference(key);
+                    break;
+                default:
+                    throw std::runtime_error{ "Invalid node kind." };
+            }
+        }
+    }
+};
+
+namespace world_image {
+    void compile(Content const& content, std::vector<SourceFile> const& sources, std::filesystem::path const& path) {
+        auto writer = ImageWriter{};
+        for (auto const& source : sources) {
+            writer.add_source(source);
+        }
+        for (auto const& item : content.items) {
+            writer.add_document(ContentKind::Item, item);
+        }
+        for (auto const& room : content.rooms) {
+            writer.add_document(ContentKind::Room, room);
+        }
+        for (auto const& dialog : content.dialogs) {
+            writer.add_document(ContentKind::Dialog, dialog);
+        }
+        for (auto const& text : content.texts) {
+            writer.add_raw_file(ContentKind::Text, text);
+        }
+        for (auto const& synonyms : content.synonyms) {
+            writer.add_raw_file(ContentKind::Synonyms, synonyms);
+        }
+        for (auto const& list : content.lists) {
+            writer.add_raw_file(ContentKind::List, list);
+        }
+
+        // Write to a temporary file first so that a running game never maps a half-written image.
+        auto const image = writer.finish();
+        auto temporary_path = path;
+        temporary_path += ".tmp";
+        {
+            auto file = std::ofstream{ temporary_path, std::ios::binary | std::ios::trunc };
+            if (not file or not file.write(image.data(), static_cast<std::streamsize>(image.size()))) {
+                throw std::runtime_error{ "Failed to write world image: " + temporary_path.string() };
+            }
+        }
+        std::filesystem::rename(temporary_path, path);
+    }
+
+    [[nodiscard]] tl::optional<Content> try_load(
+        std::filesystem::path const& path,
+        std::vector<SourceFile> const& sources
+    ) {
+        if (not std::filesystem::exists(path)) {
+            return tl::nullopt;
+        }
+        try {
+            auto const file = MappedFile{ path };
+            auto const header = read_header(file.data());
+            if (header.version != version) {
+                std::cerr << "Warning: World image \"" << path.string() << "\" has version " << header.version
+                          << " (expected " << version << "), loading source files instead.\n";
+                return tl::nullopt;
+            }
+            auto const reader = ImageReader{ file.data(), header };
+            if (not reader.matches(sources)) {
+                std::cerr << "Warning: World image \"" << path.string()
+                          << "\" is out of date, loading source files instead.\n";
+                return tl::nullopt;
+            }
+            return reader.content();
+        } catch (std::exception const& exception) {
+            std::cerr << "Warning: Unable to load world image \"" << path.string() << "\" (" << exception.what()
+                      << "), loading source files instead.\n";
+            return tl::nullopt;
+        }
+    }
+
+    [[nodiscard]] Content load(std::span<std::byte const> const image) {
+        auto const header = read_header(image);
+        if (header.version != version) {
+            throw std::runtime_error{ "World image has version " + std::to_string(header.version) + " (expected "
+                                      + std::to_string(version) + ")." };
+        }
+        return ImageReader{ image, header }.content();
+    }
+}  // namespace world_image
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <tl/optional.hpp>
+#include <vector>
+#include "content.hpp"
+
+// A world image is a single binary file containing all content files in their already parsed
+// form. Loading it replaces walking the content directories, lexing and parsing with reading one
+// mapped file. The documents are rebuilt from the image and their strings are copied out of it, so
+// the loaded content doesn't depend on the mapping. The image records the size and modification
+// time of every source file and is considered stale as soon as any of these differ from the files
+// on disk.
+namespace world_image {
+    static constexpr auto default_path = "world.img";
+
+    void compile(Content const& content, std::vector<SourceFile> const& sources, std::filesystem::path const& path);
+
+    // Returns `tl::nullopt` if there is no image at the given path or if it is stale or unusable.
+    [[nodiscard]] tl::optional<Content> try_load(
+        std::filesystem::path const& path,
+        std::vector<SourceFile> const& sources
+    );
+
+    // Loads an image that is up to date by construction (e.g. one that has been embedded into the
+    // executable), without comparing it to the source files. Throws if the image is unusable.
+    [[nodiscard]] Content load(std::span<std::byte const> image);
+}  // namespace world_image
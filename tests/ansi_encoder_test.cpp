@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <charconv>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ansi_encoder.hpp"
+#include "check.hpp"
+#include "utils.hpp"
+
+using tests::check;
+
+namespace {
+    struct Style final {
+        std::string foreground = "39";
+        std::string background = "49";
+        std::set<int> attributes;
+
+        [[nodiscard]] friend bool operator==(Style const& lhs, Style const& rhs) = default;
+    };
+
+    // A character (or any other escape sequence) together with the style it's shown in.
+    struct Cell final {
+        std::string text;
+        Style style;
+
+        [[nodiscard]] friend bool operator==(Cell const& lhs, Cell const& rhs) = default;
+    };
+}  // namespace
+
+[[nodiscard]] static std::vector<std::string_view> split_parameters(std::string_view parameters) {
+    auto result = std::vector<std::string_view>{};
+    while (true) {
+        auto const separator = parameters.find(';');
+        result.push_back(parameters.substr(0, separator));
+        if (separator == std::string_view::npos) {
+            return result;
+        }
+        parameters.remove_prefix(separator + 1);
+    }
+}
+
+static void apply_sgr(Style& style, std::string_view const parameters) {
+    auto const fields = split_parameters(parameters);
+    for (auto i = std::size_t{ 0 }; i < fields.size(); ++i) {
+        auto code = 0;
+        std::from_chars(fields.at(i).data(), fields.at(i).data() + fields.at(i).size(), code);
+        if (code == 0) {
+            style = Style{};
+        } else if (code == 38 or code == 48) {
+            auto color = std::to_string(code);
+            auto const count = (i + 1 < fields.size() and fields.at(i + 1) == "5") ? 2 : 4;
+            for (auto j = 0; j < count and i + 1 < fields.size(); ++j) {
+                color += ";" + std::string{ fields.at(++i) };
+            }
+            (code == 38 ? style.foreground : style.background) = color;
+        } else if ((code >= 30 and code <= 39) or (code >= 90 and code <= 97)) {
+            style.foreground = std::to_string(code);
+        } else if ((code >= 40 and code <= 49) or (code >= 100 and code <= 107)) {
+            style.background = std::to_string(code);
+        } else if (code == 22) {
+            style.attributes.erase(1);
+            style.attributes.erase(2);
+        } else if (code > 22 and code < 30) {
+            style.attributes.erase(code - 20);
+        } else {
+            style.attributes.insert(code);
+        }
+    }
+}
+
+// Interprets the output like a terminal would and returns what ends up on the screen. Whitespace doesn't show
+// the foreground color, so it's left out for spaces and line breaks.
+[[nodiscard]] static std::vector<Cell> render(std::string_view bytes) {
+    auto cells = std::vector<Cell>{};
+    auto style = Style{};
+    while (not bytes.empty()) {
+        if (bytes.front() != '\x1b') {
+            auto cell = Cell{ std::string{ bytes.front() }, style };
+            if (bytes.front() == ' ' or bytes.front() == '\n') {
+                cell.style.foreground.clear();
+            }
+            cells.push_back(std::move(cell));
+            bytes.remove_prefix(1);
+            continue;
+        }
+        auto const end = bytes.find_first_of("@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~", 2);
+        check(bytes.size() >= 2 and bytes.at(1) == '[' and end != std::string_view::npos);
+        auto const sequence = bytes.substr(0, end + 1);
+        if (sequence.back() == 'm') {
+            apply_sgr(style, sequence.substr(2, sequence.size() - 3));
+        } else {
+            cells.push_back(Cell{ std::string{ sequence }, style });
+        }
+        bytes.remove_prefix(sequence.size());
+    }
+    cells.push_back(Cell{ "", style });
+    return cells;
+}
+
+// Encodes the output in the same pieces in which it has been written.
+[[nodiscard]] static std::string encode(std::vector<std::string_view> const& writes) {
+    auto encoder = AnsiEncoder{};
+    for (auto const write : writes) {
+        encoder.write(write);
+    }
+    // The terminal applies the pending style before it waits for input.
+    encoder.sync();
+    return encoder.take();
+}
+
+static void check_renders_the_same(
+    std::vector<std::string_view> const& writes,
+    std::source_location const location = std::source_location::current()
+) {
+    auto raw = std::string{};
+    for (auto const write : writes) {
+        raw += write;
+    }
+    check(render(encode(writes)) == render(raw), location);
+}
+
+static void test_colors() {
+    check(encode({ "\x1b[31m\x1b[39m\x1b[31mA" }) == "\x1b[31mA");
+    check(encode({ "\x1b[31mA\x1b[0m \x1b[31mB\x1b[0m" }) == "\x1b[31mA B\x1b[0m");
+    check_renders_the_same({ "\x1b[31;44mA\x1b[39m B\x1b[0m\n", "\x1b[2J\x1b[H", "\x1b[93mC" });
+    check_renders_the_same({ "\x1b[38;5;208mA\x1b[39mB\x1b[48;2;1;2;3m C", "\x1b[38;2;4;5;6mD\x1b[0m" });
+}
+
+// Attributes other than colors are only turned off by a reset, which must not be dropped.
+static void test_attributes() {
+    check_renders_the_same({ "\x1b[1mA\x1b[0mB" });
+    check_renders_the_same({ "\x1b[1;31mA\x1b[0;31mB\x1b[0m" });
+    check_renders_the_same({ "\x1b[4mA\x1b[0m B" });
+    check_renders_the_same({ "\x1b[31m\x1b[4mA", "\x1b[0m\x1b[31m", " B\x1b[39mC" });
+    check_renders_the_same({ "\x1b[7m\x1b[0m\x1b[2JA" });
+}
+
+// The output of a whole playthrough must look exactly like before it has been encoded, while taking fewer bytes.
+static void test_playthrough(char const* const transcript_path) {
+    auto const contents = read_file(transcript_path);
+    auto const transcript = contents.view();
+    check(not transcript.empty());
+
+    // The terminal writes the output a line at a time at most, so it's encoded in lines here.
+    auto lines = std::vector<std::string_view>{};
+    for (auto rest = transcript; not rest.empty();) {
+        auto const line = rest.substr(0, std::min(rest.find('\n'), rest.size() - 1) + 1);
+        lines.push_back(line);
+        rest.remove_prefix(line.size());
+    }
+    auto const encoded = encode(lines);
+    check(render(encoded) == render(transcript));
+    check(encoded.size() < transcript.size());
+}
+
+int main(int const argc, char** const argv) {
+    test_colors();
+    test_attributes();
+    check(argc == 2);
+    if (argc == 2) {
+        test_playthrough(argv[1]);
+    }
+    return tests::exit_code();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <source_location>
+
+// Instead of a test framework, failed checks are reported on stderr and decide the exit code of the test.
+namespace tests {
+    inline auto failed_checks = 0;
+
+    inline void check(bool const condition, std::source_location const location = std::source_location::current()) {
+        if (not condition) {
+            std::cerr << location.file_name() << ':' << location.line() << ": check failed\n";
+            ++failed_checks;
+        }
+    }
+
+    [[nodiscard]] inline int exit_code() {
+        if (failed_checks > 0) {
+            std::cerr << failed_checks << " check(s) failed\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+}  // namespace tests
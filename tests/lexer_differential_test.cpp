@@ -0,0 +1,219 @@
+#include <array>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "check.hpp"
+#include "content.hpp"
+#include "lexer.hpp"
+#include "reference_lexer.hpp"
+#include "utils.hpp"
+
+using tests::check;
+
+// Compares the vectorized scanners against the scalar one on the level of single scans, and the tokens
+// (and errors) the lexer produces with each of them against the lexer from before the vectorization. The
+// inputs are chosen so that the interesting bytes end up on and around the block boundaries and in the
+// scalar tail.
+
+namespace {
+    struct TokenData final {
+        TokenType type;
+        u32 offset;
+        u32 length;
+
+        [[nodiscard]] friend bool operator==(TokenData const& lhs, TokenData const& rhs) = default;
+    };
+
+    struct LexResult final {
+        std::vector<TokenData> tokens;
+        std::string error;
+
+        [[nodiscard]] friend bool operator==(LexResult const& lhs, LexResult const& rhs) = default;
+    };
+}  // namespace
+
+template<typename LexerType>
+[[nodiscard]] static LexResult lex(c2k::Utf8String const& source) {
+    auto result = LexResult{};
+    try {
+        auto lexer = LexerType{ source };
+        // Every byte produces at most a few tokens, so this only stops a lexer that doesn't terminate.
+        auto const max_tokens = 4 * source.view().size() + 16;
+        while (result.tokens.size() < max_tokens) {
+            auto const token = lexer.next();
+            result.tokens.push_back(TokenData{ token.type, token.offset, token.length });
+            if (token.type == TokenType::EndOfInput) {
+                return result;
+            }
+        }
+        result.error = "no end of input";
+    } catch (std::runtime_error const& error) {
+        result.error = error.what();
+    }
+    return result;
+}
+
+template<typename Scanner>
+static void check_scans(std::string_view const text) {
+    using Reference = byte_scan::ScalarScanner;
+    for (auto const byte : std::array{ '\n', ' ', '"', static_cast<char>(0xFF) }) {
+        check(Scanner::find_last(text, byte) == Reference::find_last(text, byte));
+    }
+    // Starting at the beginning, inside the first block, and right before, at and after block boundaries.
+    for (auto const from : std::array<usize, 8>{ 0, 1, 15, 16, 17, 31, 32, 33 }) {
+        if (from > text.size()) {
+            break;
+        }
+        for (auto const byte : std::array{ '\n', ' ', '"', static_cast<char>(0xFF) }) {
+            check(Scanner::find(text, from, byte) == Reference::find(text, from, byte));
+            check(Scanner::skip(text, from, byte) == Reference::skip(text, from, byte));
+        }
+        check(Scanner::skip_whitespace(text, from) == Reference::skip_whitespace(text, from));
+        check(Scanner::skip_blanks(text, from) == Reference::skip_blanks(text, from));
+        check(Scanner::skip_identifier(text, from) == Reference::skip_identifier(text, from));
+    }
+}
+
+static void check_lex(std::string const& source) {
+    auto const text = c2k::Utf8String{ source };
+    auto const expected = lex<ReferenceLexer>(text);
+    check(lex<BasicLexer<byte_scan::ScalarScanner>>(text) == expected);
+#ifdef GUESS_WHAT_SSE2
+    check(lex<BasicLexer<byte_scan::Sse2Scanner>>(text) == expected);
+#endif
+#ifdef GUESS_WHAT_AVX2
+    if (byte_scan::cpu_supports_avx2()) {
+        check(lex<BasicLexer<byte_scan::Avx2Scanner>>(text) == expected);
+    }
+#endif
+    check(lex<Lexer>(text) == expected);
+}
+
+static void check_all_scans(std::string_view const text) {
+#ifdef GUESS_WHAT_SSE2
+    check_scans<byte_scan::Sse2Scanner>(text);
+#endif
+#ifdef GUESS_WHAT_AVX2
+    if (byte_scan::cpu_supports_avx2()) {
+        check_scans<byte_scan::Avx2Scanner>(text);
+    }
+#endif
+}
+
+// Places the bytes the scanners look for (and their neighbours) at every position of a run of filler
+// bytes, for all lengths up to a bit more than two AVX2 blocks. Every possible byte value is placed at
+// every position of the longest run.
+static void test_scans() {
+    static constexpr auto interesting_bytes = std::array<char, 25>{
+        '\0', '\b', '\t', '\n', '\v', '\r', '\x0E', ' ', '"', ',', '/', '0', '9', ':', '@',
+        'A', 'Z', '[', '_', '`', 'a', 'z', '{', '\x7F', static_cast<char>(0xFF),
+    };
+    static constexpr auto max_length = usize{ 70 };
+    for (auto const filler : std::array{ ' ', 'a' }) {
+        for (auto length = usize{ 0 }; length <= max_length; ++length) {
+            auto text = std::string(length, filler);
+            check_all_scans(text);
+            for (auto position = usize{ 0 }; position < length; ++position) {
+                for (auto const byte : interesting_bytes) {
+                    text[position] = byte;
+                    check_all_scans(text);
+                }
+                text[position] = filler;
+            }
+        }
+
+        auto text = std::string(max_length, filler);
+        for (auto position = usize{ 0 }; position < max_length; ++position) {
+            for (auto value = 0; value < 256; ++value) {
+                text[position] = static_cast<char>(value);
+                check_all_scans(text);
+            }
+            text[position] = filler;
+        }
+    }
+}
+
+static void test_content_files() {
+    auto const sources = collect_source_files();
+    check(not sources.empty());
+    for (auto const& source : sources) {
+        check_lex(std::string{ read_file(source.path).view() });
+    }
+}
+
+static void test_malformed_inputs() {
+    for (auto const& source : std::array<std::string, 14>{
+             "",
+             "\nkey: value\n",
+             " key: value\n",
+             "key: \"unterminated\n",
+             "key: \"text\" trailing\n",
+             "key: / comment\n",
+             "key:\n\tvalue: text\n",
+             "key:\n   a: b\n  c: d\n",
+             "key: \xC3\xA4\n",
+             "key: \"text\"\r\n",
+             "key: \"\"\"\n",
+             "key:\n  \n  // comment\n\n  a: b\n",
+             "key: value",
+             "key:\n  a:\n    b: c\nd: e\n",
+         }) {
+        check_lex(source);
+    }
+}
+
+// Moves the interesting parts of each line across the block boundaries by padding them.
+static void test_boundary_lengths() {
+    for (auto length = usize{ 0 }; length <= 100; ++length) {
+        auto const padding = std::string(length, ' ');
+        auto const filler = std::string(length, 'x');
+        check_lex("key:" + padding + "value\n");
+        check_lex("key: \"" + filler + "\"" + padding + "\nnext: value\n");
+        check_lex("key: \"" + filler + "\"" + padding + "x\n");
+        check_lex("key: \"" + filler + "\n");
+        check_lex("key: \"" + filler + "\"" + filler + "\"\n");
+        check_lex("a:\n" + padding + "b: c\n" + padding + "d: e\n");
+        check_lex("a:\n  b:\n" + padding + "c: d\n");
+        check_lex("// " + filler + "\nkey: value\n");
+        check_lex("key: value\n" + padding + "\n" + padding + "// comment\nnext: value\n");
+        check_lex("key: value" + padding);
+        check_lex(filler + ": " + filler + ", " + filler + "\n");
+        check_lex("key:" + padding + "\t" + padding + "value\n");
+        check_lex("key: value\n" + std::string(length, '\n') + "next: value\n");
+    }
+}
+
+// Random sequences of the characters the lexer treats specially, plus a multibyte character.
+static void test_random_inputs() {
+    static constexpr auto alphabet = std::array<std::string_view, 12>{
+        " ", "  ", "\n", "\t", "\r", "\"", ":", ",", "/", "a", "key", "\xC3\xA4",
+    };
+    auto generator = std::mt19937{ 42 };
+    auto pick = std::uniform_int_distribution<usize>{ 0, alphabet.size() - 1 };
+    auto length = std::uniform_int_distribution<usize>{ 0, 80 };
+    for (auto i = 0; i < 20'000; ++i) {
+        auto source = std::string{ "key: " };
+        auto const count = length(generator);
+        for (auto j = usize{ 0 }; j < count; ++j) {
+            source += alphabet.at(pick(generator));
+        }
+        check_lex(source);
+    }
+}
+
+int main() {
+#ifdef GUESS_WHAT_AVX2
+    if (not byte_scan::cpu_supports_avx2()) {
+        std::cerr << "AVX2 is not supported by this machine, only the SSE2 scanner is tested\n";
+    }
+#endif
+    test_scans();
+    test_content_files();
+    test_malformed_inputs();
+    test_boundary_lengths();
+    test_random_inputs();
+    return tests::exit_code();
+}
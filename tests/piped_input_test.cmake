@@ -0,0 +1,15 @@
+# Runs the game with its standard input read from a file and checks that it quits normally when the
+# input ends: cmake -DPROGRAM=<path> -DINPUT=<path> -P piped_input_test.cmake
+execute_process(
+        COMMAND ${PROGRAM}
+        INPUT_FILE ${INPUT}
+        RESULT_VARIABLE result
+        OUTPUT_QUIET
+        ERROR_VARIABLE errors
+)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "The game exited with ${result}:\n${errors}")
+endif ()
+if (errors MATCHES "Error:")
+    message(FATAL_ERROR "The game reported an error:\n${errors}")
+endif ()
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <lib2k/types.hpp>
+#include <lib2k/utf8/string.hpp>
+#include <lib2k/utf8/string_view.hpp>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "token.hpp"
+#include "utils.hpp"
+
+// The lexer as it was before its hot loops were vectorized, scanning the source one byte at a time.
+// It is kept unchanged as the reference that the results of `Lexer` must match exactly.
+class ReferenceLexer final {
+private:
+    std::string_view m_source;
+    usize m_position = 0;
+    std::optional<usize> m_indentation_step;
+    usize m_indentation = 0;         // Measured in multiples of the step size.
+    usize m_target_indentation = 0;  // Indentation of the current line.
+
+public:
+    explicit ReferenceLexer(c2k::Utf8StringView const source)
+        : m_source{ source.view() } {
+        if (m_source.size() > std::numeric_limits<u32>::max()) {
+            throw std::runtime_error{ "Source file too large." };
+        }
+
+        if (current() == '\n') {
+            throw std::runtime_error{ "First line must not be empty." };
+        }
+
+        if (is_whitespace(current())) {
+            throw std::runtime_error{ "First line must not start indented." };
+        }
+    }
+
+    // Returns the next token. Once the end of the input has been reached, this keeps returning
+    // END_OF_INPUT tokens.
+    [[nodiscard]] Token next() {
+        if (auto const pending = pending_indentation_token()) {
+            return pending.value();
+        }
+
+        while (not is_at_end()) {
+            if (current() == ',') {
+                auto const comma = token(TokenType::Comma, m_position, m_position);
+                advance();
+                return comma;
+            }
+
+            if (current() == ':') {
+                auto const colon = token(TokenType::Colon, m_position, m_position);
+                advance();
+                return colon;
+            }
+
+            if (current() == '\n') {
+                auto const linebreak = token(TokenType::Linebreak, m_position, m_position);
+                advance();
+                begin_line();
+                return linebreak;
+            }
+
+            if (current() == '/') {
+                advance();
+                if (current() != '/') {
+                    throw std::runtime_error{ "Illegal token '/' (did you mean '//' to start a comment?)" };
+                }
+                m_position = line_end();
+                continue;
+            }
+
+            if (current() == '"') {
+                advance();
+                auto const string_start = m_position;
+                auto const string_end = line_end();
+                auto const last_quotes = m_source.substr(string_start, string_end - string_start).rfind('"');
+                if (last_quotes == std::string_view::npos) {
+                    throw std::runtime_error{ "Unterminated string literal." };
+                }
+                for (auto i = string_start + last_quotes + 1; i < string_end; ++i) {
+                    if (not is_whitespace(m_source[i])) {
+                        throw std::runtime_error{ "String literal must be the last token of line." };
+                    }
+                }
+                m_position = string_end;
+                return token(TokenType::String, string_start, string_start + last_quotes);
+            }
+
+            if (is_whitespace(current())) {
+                advance();
+                continue;
+            }
+
+            // Identifier.
+            if (not is_valid_identifier_char(current())) {
+                throw std::runtime_error{ "Expected identifier, got " + std::string{ current_utf8_char() } + "." };
+            }
+            auto const identifier_start = m_position;
+            while (is_valid_identifier_char(current())) {
+                advance();
+            }
+            return token(TokenType::Identifier, identifier_start, m_position);
+        }
+
+        // Close all open indentation levels before the end of the input.
+        m_target_indentation = 0;
+        if (auto const pending = pending_indentation_token()) {
+            return pending.value();
+        }
+        return token(TokenType::EndOfInput, m_position, m_position);
+    }
+
+private:
+    // Skips blank and comment lines and determines the indentation of the next line. The
+    // corresponding INDENT and DEDENT tokens are returned by the following calls to `next()`.
+    void begin_line() {
+        auto next_newline = m_source.find('\n', m_position);
+        while (next_newline != std::string_view::npos) {
+            if (is_blank_or_comment(m_source.substr(m_position, next_newline - m_position))) {
+                m_position = next_newline;
+                advance();
+                next_newline = m_source.find('\n', m_position);
+            } else {
+                break;
+            }
+        }
+
+        if (is_whitespace(current()) and current() != ' ' and current() != '\n') {
+            throw std::runtime_error{ "Lines must not start with whitespace except for regular spaces." };
+        }
+        auto num_leading_spaces = usize{ 0 };
+        while (current() == ' ') {
+            advance();
+            ++num_leading_spaces;
+        }
+        if (not m_indentation_step.has_value()) {
+            if (num_leading_spaces > 0) {
+                m_indentation_step = num_leading_spaces;
+                m_target_indentation = 1;
+            }
+            return;
+        }
+        if (num_leading_spaces % m_indentation_step.value() != 0) {
+            throw std::runtime_error{ "Unexpected indentation " + std::to_string(num_leading_spaces)
+                                      + " (must be multiple of " + std::to_string(m_indentation_step.value())
+                                      + ")." };
+        }
+        m_target_indentation = num_leading_spaces / m_indentation_step.value();
+    }
+
+    [[nodiscard]] std::optional<Token> pending_indentation_token() {
+        if (m_indentation < m_target_indentation) {
+            ++m_indentation;
+            return token(TokenType::Indent, m_position, m_position);
+        }
+        if (m_indentation > m_target_indentation) {
+            --m_indentation;
+            return token(TokenType::Dedent, m_position, m_position);
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] static Token token(TokenType const type, usize const begin, usize const end) {
+        return Token{ type, static_cast<u32>(begin), static_cast<u32>(end - begin) };
+    }
+
+    [[nodiscard]] bool is_at_end() const {
+        return m_position >= m_source.size();
+    }
+
+    [[nodiscard]] char current() const {
+        if (is_at_end()) {
+            return '\0';
+        }
+        return m_source[m_position];
+    }
+
+    // Returns all bytes of the (possibly multibyte) character at the current position.
+    [[nodiscard]] std::string_view current_utf8_char() const {
+        auto const lead = static_cast<unsigned char>(current());
+        auto const length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+        return m_source.substr(m_position, static_cast<usize>(length));
+    }
+
+    // Returns the position of the next linebreak (or the end of the source).
+    [[nodiscard]] usize line_end() const {
+        return std::min(m_source.find('\n', m_position), m_source.size());
+    }
+
+    void advance() {
+        if (is_at_end()) {
+            return;
+        }
+        ++m_position;
+    }
+
+    [[nodiscard]] static bool is_blank_or_comment(std::string_view const line) {
+        for (auto i = usize{ 0 }; i < line.size(); ++i) {
+            if (not is_whitespace(line[i])) {
+                return line.substr(i).starts_with("//");
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] static bool is_valid_identifier_char(char const c) {
+        return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z') or (c >= '0' and c <= '9') or c == '_';
+    }
+};